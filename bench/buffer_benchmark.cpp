@@ -0,0 +1,191 @@
+#include <glimpse/allocation_counter.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+#include <glimpse/program.hpp>
+#include <glimpse/upload_queue.hpp>
+#include <glimpse/vertex_array.hpp>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/*
+ * Compares the upload and draw throughput of mutable buffers created with a
+ * gl::Buffer::Type hint against immutable buffers created with
+ * gl::Buffer::Storage flags.
+ *
+ * Also checks that steady-state gl::UploadQueue writes and flushes do not
+ * allocate, when the library is built with ENABLE_ALLOCATION_COUNTER, and
+ * fails if they do.
+ *
+ * Usage: buffer_benchmark [vertices] [iterations]
+ */
+
+static const char* VERTEX_SHADER = R"(#version 450
+in vec3 position;
+void main() {
+    gl_Position = vec4(position, 1.0);
+}
+)";
+
+static const char* FRAGMENT_SHADER = R"(#version 450
+out vec4 color;
+void main() {
+    color = vec4(1.0);
+}
+)";
+
+namespace {
+/**
+ * A way of allocating the vertex buffer under test.
+ */
+struct Mode {
+    const char* name;
+    std::function<gl::Data(const std::vector<glm::vec3>&)> create;
+    bool writable;
+};
+}  // namespace
+
+/**
+ * Count the heap allocations of queueing and flushing small writes to a
+ * buffer, after warming up the queue so its storage has reached its final size.
+ */
+static size_t count_upload_allocations(size_t iterations) {
+    gl::Buffer buffer(64 * 1024, gl::Buffer::Type::DYNAMIC);
+    gl::UploadQueue queue(1024 * 1024);
+    std::vector<unsigned char> data(256, 0xFF);
+
+    auto frame = [&]() {
+        for (size_t offset = 0; offset < buffer.size(); offset += 2 * data.size()) {
+            queue.write(buffer, data, offset);
+        }
+        queue.flush();
+    };
+
+    for (size_t i = 0; i < 8; i++) {
+        frame();
+    }
+
+    gl::AllocationCounter counter;
+    for (size_t i = 0; i < iterations; i++) {
+        frame();
+    }
+    return counter.allocations();
+}
+
+/**
+ * Run the function the specified number of times and return the average
+ * duration of an iteration in milliseconds, including the time the GPU needs
+ * to finish the issued commands.
+ */
+static double measure(size_t iterations, const std::function<void()>& function) {
+    glFinish();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        function();
+    }
+    glFinish();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char** argv) {
+    const size_t vertices = argc > 1 ? std::strtoul(argv[1], nullptr, 10) / 3 * 3 : 3 * 1024 * 1024;
+    const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+    if (vertices == 0 || iterations == 0) {
+        std::fprintf(stderr, "Usage: %s [vertices] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!glfwInit()) {
+        std::fprintf(stderr, "Failed to initialize GLFW\n");
+        return EXIT_FAILURE;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(256, 256, "buffer_benchmark", nullptr, nullptr);
+    if (!window) {
+        std::fprintf(stderr, "Failed to create an OpenGL 4.5 context\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK) {
+        std::fprintf(stderr, "Failed to initialize GLEW\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+
+    bool allocation_free = true;
+    {
+        auto program = std::make_shared<gl::Program>(gl::ProgramBuilder()
+                                                          .add_source(GL_VERTEX_SHADER, VERTEX_SHADER)
+                                                          .add_source(GL_FRAGMENT_SHADER, FRAGMENT_SHADER)
+                                                          .build());
+
+        // Degenerate triangles, so the draws measure vertex fetch rather than rasterization
+        std::vector<glm::vec3> data(vertices, glm::vec3(0.0f));
+
+        const Mode modes[] = {
+            {"Type::STATIC", [](const auto& data) { return gl::Data(data, gl::Buffer::Type::STATIC); }, true},
+            {"Type::DYNAMIC", [](const auto& data) { return gl::Data(data, gl::Buffer::Type::DYNAMIC); }, true},
+            {"Type::STREAM", [](const auto& data) { return gl::Data(data, gl::Buffer::Type::STREAM); }, true},
+            {"Storage::NONE", [](const auto& data) { return gl::Data(data, gl::Buffer::Storage::NONE); }, false},
+            {"Storage::DYNAMIC_STORAGE",
+             [](const auto& data) { return gl::Data(data, gl::Buffer::Storage::DYNAMIC_STORAGE); },
+             true},
+        };
+
+        const double megabytes = static_cast<double>(data.size() * sizeof(glm::vec3)) / (1024.0 * 1024.0);
+        std::printf("%zu vertices (%.1f MiB), %zu iterations\n\n", vertices, megabytes, iterations);
+        std::printf("%-26s %12s %12s %12s\n", "mode", "upload MiB/s", "draw ms", "frame ms");
+
+        for (const Mode& mode : modes) {
+            gl::Data view = mode.create(data);
+            gl::VertexArray vao(program, {{"position", view}});
+            gl::Buffer& buffer = view.buffer();
+
+            program->use();
+            vao.render(GL_TRIANGLES);
+
+            double draw = measure(iterations, [&]() { vao.render(GL_TRIANGLES); });
+
+            if (mode.writable) {
+                double upload = measure(iterations, [&]() { buffer.write(data); });
+                double frame = measure(iterations, [&]() {
+                    buffer.write(data);
+                    vao.render(GL_TRIANGLES);
+                });
+                std::printf("%-26s %12.1f %12.3f %12.3f\n", mode.name, megabytes / (upload / 1000.0), draw, frame);
+            } else {
+                std::printf("%-26s %12s %12.3f %12s\n", mode.name, "-", draw, "-");
+            }
+        }
+
+        if (gl::AllocationCounter::enabled()) {
+            size_t allocations = count_upload_allocations(iterations);
+            std::printf("\nUploadQueue write+flush: %zu allocations in %zu frames\n", allocations, iterations);
+            allocation_free = allocations == 0;
+        } else {
+            std::printf("\nUploadQueue write+flush: allocation counting disabled\n");
+        }
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return allocation_free ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,50 @@
+#ifndef GLIMPSE_ALLOCATION_COUNTER_H
+#define GLIMPSE_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+namespace gl {
+/**
+ * An {@link AllocationCounter} is a test hook that counts the heap
+ * allocations of the calling thread since the counter was created, e.g. to
+ * verify that steady-state uploads do not allocate:
+ *
+ * <pre>
+ * queue.write(buffer, data);
+ * queue.flush();
+ *
+ * gl::AllocationCounter counter;
+ * queue.write(buffer, data);
+ * queue.flush();
+ * assert(counter.allocations() == 0);
+ * </pre>
+ *
+ * Counting replaces the global <code>operator new</code> and is only compiled
+ * in when the library is built with the <code>ENABLE_ALLOCATION_COUNTER</code>
+ * CMake option. Otherwise {@link #enabled()} returns false and no allocations
+ * are counted.
+ */
+class AllocationCounter {
+public:
+    /**
+     * Start counting the allocations of the calling thread.
+     */
+    AllocationCounter() noexcept;
+
+    /**
+     * The number of allocations made by the calling thread since the counter
+     * was created.
+     */
+    size_t allocations() const noexcept;
+
+    /**
+     * Determine whether the library was built with allocation counting.
+     */
+    static bool enabled() noexcept;
+
+private:
+    size_t m_start;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_ALLOCATION_COUNTER_H */
@@ -0,0 +1,85 @@
+#ifndef GLIMPSE_BARRIER_H
+#define GLIMPSE_BARRIER_H
+
+#include <glimpse/gl.hpp>
+
+namespace gl {
+/**
+ * An enumeration of the ways in which data written by shaders, e.g. to
+ * shader storage blocks or images, may be consumed afterwards. The flags
+ * may be combined using <code>operator|</code>.
+ */
+enum class Barrier : unsigned {
+    NONE = 0,
+    /**
+     * Vertex attributes sourced from buffers.
+     */
+    VERTEX_ATTRIB_ARRAY = 1u << 0,
+    /**
+     * Indices sourced from element array buffers.
+     */
+    ELEMENT_ARRAY = 1u << 1,
+    /**
+     * Uniform blocks sourced from buffers.
+     */
+    UNIFORM = 1u << 2,
+    /**
+     * Texture fetches from shaders.
+     */
+    TEXTURE_FETCH = 1u << 3,
+    /**
+     * Image loads, stores and atomics from shaders.
+     */
+    SHADER_IMAGE_ACCESS = 1u << 4,
+    /**
+     * Indirect draw and dispatch commands sourced from buffers.
+     */
+    COMMAND = 1u << 5,
+    /**
+     * Pixel transfers through pixel buffers.
+     */
+    PIXEL_BUFFER = 1u << 6,
+    /**
+     * Writes to and reads from textures through the API.
+     */
+    TEXTURE_UPDATE = 1u << 7,
+    /**
+     * Writes to, reads from and copies between buffers through the API.
+     */
+    BUFFER_UPDATE = 1u << 8,
+    /**
+     * Reads from and writes to framebuffer attachments.
+     */
+    FRAMEBUFFER = 1u << 9,
+    /**
+     * Transform feedback writes to buffers.
+     */
+    TRANSFORM_FEEDBACK = 1u << 10,
+    /**
+     * Atomic counters sourced from buffers.
+     */
+    ATOMIC_COUNTER = 1u << 11,
+    /**
+     * Shader storage blocks sourced from buffers.
+     */
+    SHADER_STORAGE = 1u << 12,
+    /**
+     * All of the above.
+     */
+    ALL = (1u << 13) - 1,
+};
+
+inline Barrier operator|(Barrier lhs, Barrier rhs) noexcept {
+    return static_cast<Barrier>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+/**
+ * Order shader writes issued before the barrier with the specified kinds of
+ * accesses issued after it.
+ *
+ * @param[in] barrier The ways in which the written data is consumed.
+ */
+void memory_barrier(Barrier barrier) noexcept;
+}  // namespace gl
+
+#endif /* GLIMPSE_BARRIER_H */
@@ -0,0 +1,143 @@
+#ifndef GLIMPSE_BLOCK_H
+#define GLIMPSE_BLOCK_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/block_layout.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+#include <glimpse/member.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace gl {
+/**
+ * An interface block of a shader program, i.e. a group of uniforms or shader
+ * storage variables that is backed by a range of a buffer bound to one of the
+ * binding points of the context.
+ */
+class Block : public Member {
+public:
+    /**
+     * An enumeration of the kinds of interface blocks.
+     */
+    enum class Kind {
+        /**
+         * A uniform block, laid out with std140.
+         */
+        UNIFORM,
+        /**
+         * A shader storage block, laid out with std430.
+         */
+        SHADER_STORAGE,
+    };
+
+    /**
+     * Create an invalid block.
+     */
+    Block() noexcept;
+
+    /**
+     * Create a block.
+     *
+     * @param[in] handle The program this block belongs to.
+     * @param[in] name The name of the block.
+     * @param[in] kind The kind of block.
+     * @param[in] index The index of the block in the program.
+     * @param[in] binding The binding point the block reads from.
+     * @param[in] size The minimum size in bytes of the buffer range backing
+     * the block. Runtime sized arrays count as a single element.
+     */
+    Block(gl::Handle handle,
+          const std::string& name,
+          Block::Kind kind,
+          unsigned index,
+          unsigned binding,
+          size_t size) noexcept;
+
+    /**
+     * The kind of block.
+     */
+    Block::Kind kind() const noexcept;
+
+    /**
+     * The index of the block in the program.
+     */
+    unsigned index() const noexcept;
+
+    /**
+     * The binding point the block reads from.
+     */
+    unsigned binding() const noexcept;
+
+    /**
+     * The minimum size in bytes of the buffer range backing the block.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * Let the block read from the specified binding point. Programs that
+     * read the same data should use the same binding point, so that a range
+     * bound once serves all of them.
+     *
+     * @param[in] binding The binding point to read from.
+     */
+    void set_binding(unsigned binding) noexcept;
+
+    /**
+     * Bind the range represented by the view to the binding point of the block.
+     *
+     * @param[in] data The view on the buffer that backs the block.
+     */
+    void bind(const gl::Data& data) const;
+
+    /**
+     * Bind the range represented by the view to the binding point of a
+     * uniform block. If the structure declares its members, its layout is
+     * checked against the std140 rules at compile time.
+     *
+     * @param[in] data The view on the buffer that backs the block.
+     */
+    template <typename T>
+    void bind_uniform(const gl::TypedData<T>& data) const {
+        if constexpr (gl::has_members<T>::value) {
+            static_assert(gl::is_block_layout<T, gl::BlockLayout::STD140>::value,
+                          "T does not follow the std140 layout, reorder its members or insert gl::Padding");
+        }
+        if (m_kind != Block::Kind::UNIFORM) {
+            throw std::logic_error("The block " + name() + " is not a uniform block");
+        }
+        bind(static_cast<const gl::Data&>(data));
+    }
+
+    /**
+     * Bind the range represented by the view to the binding point of a
+     * shader storage block. If the elements are structures that declare their
+     * members, their layout is checked against the std430 rules at compile
+     * time, including the array stride of consecutive elements.
+     *
+     * @param[in] data The view on the buffer that backs the block.
+     */
+    template <typename T>
+    void bind_storage(const gl::TypedData<T>& data) const {
+        if constexpr (gl::has_members<T>::value) {
+            static_assert(gl::is_block_layout<T, gl::BlockLayout::STD430>::value &&
+                              gl::block_traits<T, gl::BlockLayout::STD430>::size == sizeof(T),
+                          "T does not follow the std430 layout, reorder its members or insert gl::Padding");
+        }
+        if (m_kind != Block::Kind::SHADER_STORAGE) {
+            throw std::logic_error("The block " + name() + " is not a shader storage block");
+        }
+        bind(static_cast<const gl::Data&>(data));
+    }
+
+private:
+    Block::Kind m_kind{Block::Kind::UNIFORM};
+    unsigned m_index{0xFFFFFFFF};
+    unsigned m_binding{0};
+    size_t m_size{0};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_BLOCK_H */
@@ -0,0 +1,252 @@
+#ifndef GLIMPSE_BLOCK_LAYOUT_H
+#define GLIMPSE_BLOCK_LAYOUT_H
+
+#include <glimpse/gl.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+namespace gl {
+/**
+ * An enumeration of the standard memory layouts of interface blocks.
+ */
+enum class BlockLayout {
+    /**
+     * The layout of uniform blocks, which rounds the alignment of arrays and
+     * structures up to the alignment of a <code>vec4</code>.
+     */
+    STD140,
+    /**
+     * The layout of shader storage blocks, which packs arrays and structures
+     * at the alignment of their elements.
+     */
+    STD430,
+};
+
+/**
+ * Explicit padding inside a structure that is shared with the GPU, e.g. to
+ * fill the gap after a <code>vec3</code>.
+ */
+template <size_t N>
+struct Padding {
+    unsigned char bytes[N];
+};
+
+/**
+ * The ordered list of the members of a structure that is shared with the GPU.
+ *
+ * A structure declares its members in a static member named
+ * <code>layout</code>, from which its layout is checked at compile time:
+ *
+ * <pre>
+ * struct Camera {
+ *     glm::mat4 view;
+ *     glm::vec3 position;
+ *     float exposure;
+ *
+ *     static constexpr auto layout = gl::members(&Camera::view, &Camera::position, &Camera::exposure);
+ * };
+ * </pre>
+ *
+ * The member pointers only convey the types of the members, their offsets
+ * cannot be read at compile time. The check therefore recomputes the native
+ * offsets from the declared order, which must be the order of declaration in
+ * the structure; a list in another order is only rejected if it changes the
+ * size of the structure.
+ */
+template <typename... M>
+struct Members {
+    /**
+     * The alignment of the structure in the specified layout, or 0 if a
+     * member cannot be represented.
+     */
+    template <BlockLayout L>
+    static constexpr size_t alignment() noexcept;
+
+    /**
+     * The offset past the last member in the specified layout.
+     */
+    template <BlockLayout L>
+    static constexpr size_t end() noexcept;
+
+    /**
+     * The offset past the last member in the native layout of the compiler.
+     */
+    static constexpr size_t native_end() noexcept;
+
+    /**
+     * Determine whether every member is placed at the same offset and with
+     * the same size in the native layout and the specified layout, assuming
+     * the members are listed in order of declaration.
+     */
+    template <BlockLayout L>
+    static constexpr bool matches() noexcept;
+};
+
+/**
+ * Declare the members of a structure that is shared with the GPU, in order
+ * of declaration.
+ */
+template <typename T, typename... M>
+constexpr Members<M...> members(M T::*...) noexcept {
+    return {};
+}
+
+/**
+ * Round the value up to a multiple of the alignment.
+ */
+constexpr size_t align_up(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * The base alignment and size of type <code>T</code> in the specified
+ * layout. Types that cannot be represented have an alignment of 0.
+ */
+template <typename T, BlockLayout L, typename = void>
+struct block_traits {
+    static constexpr size_t alignment = 0;
+    static constexpr size_t size = 0;
+};
+
+/**
+ * Determine whether <code>T</code> is a GLM matrix type.
+ */
+template <typename T, typename = void>
+struct is_matrix : std::false_type {};
+
+template <typename T>
+struct is_matrix<T, std::void_t<typename T::col_type>> : std::true_type {};
+
+/**
+ * Determine whether <code>T</code> is a GLM vector type.
+ */
+template <typename T, typename = void>
+struct is_vector : std::false_type {};
+
+template <typename T>
+struct is_vector<T, std::void_t<typename T::value_type, decltype(T::length())>>
+    : std::bool_constant<!is_matrix<T>::value> {};
+
+/**
+ * Determine whether <code>T</code> declares its members for layout checks.
+ */
+template <typename T, typename = void>
+struct has_members : std::false_type {};
+
+template <typename T>
+struct has_members<T, std::void_t<decltype(T::layout)>> : std::true_type {};
+
+// Scalars, except bool which has no portable size
+template <typename T, BlockLayout L>
+struct block_traits<T, L, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>> {
+    static constexpr size_t alignment = sizeof(T);
+    static constexpr size_t size = sizeof(T);
+};
+
+// Vectors are aligned to two or four components
+template <typename T, BlockLayout L>
+struct block_traits<T, L, std::enable_if_t<is_vector<T>::value>> {
+    using component = block_traits<typename T::value_type, L>;
+    static constexpr size_t length = static_cast<size_t>(T::length());
+
+    static constexpr size_t alignment = component::alignment * (length == 2 ? 2 : 4);
+    static constexpr size_t size = component::size * length;
+};
+
+// Arrays round their stride up to their alignment, which std140 rounds up to a vec4
+template <typename T, size_t N, BlockLayout L>
+struct block_traits<T[N], L> {
+    using element = block_traits<T, L>;
+
+    static constexpr size_t alignment =
+        L == BlockLayout::STD140 && element::alignment != 0 ? align_up(element::alignment, 16) : element::alignment;
+    static constexpr size_t stride = alignment != 0 ? align_up(element::size, alignment) : 0;
+    static constexpr size_t size = stride * N;
+};
+
+// Column major matrices are laid out as arrays of their column vectors
+template <typename T, BlockLayout L>
+struct block_traits<T, L, std::enable_if_t<is_matrix<T>::value>>
+    : block_traits<typename T::col_type[static_cast<size_t>(T::length())], L> {};
+
+// Padding is placed as is
+template <size_t N, BlockLayout L>
+struct block_traits<Padding<N>, L> {
+    static constexpr size_t alignment = 1;
+    static constexpr size_t size = N;
+};
+
+// Structures that declare their members
+template <typename T, BlockLayout L>
+struct block_traits<T, L, std::enable_if_t<has_members<T>::value>> {
+    using members = std::decay_t<decltype(T::layout)>;
+
+    static constexpr size_t alignment = members::template alignment<L>();
+    static constexpr size_t size = alignment != 0 ? align_up(members::template end<L>(), alignment) : 0;
+};
+
+template <typename... M>
+template <BlockLayout L>
+constexpr size_t Members<M...>::alignment() noexcept {
+    if (((block_traits<M, L>::alignment == 0) || ...)) {
+        return 0;
+    }
+
+    size_t alignment = L == BlockLayout::STD140 ? 16 : 1;
+    ((alignment = std::max(alignment, block_traits<M, L>::alignment)), ...);
+    return alignment;
+}
+
+template <typename... M>
+template <BlockLayout L>
+constexpr size_t Members<M...>::end() noexcept {
+    size_t end = 0;
+    ((end = align_up(end, std::max<size_t>(block_traits<M, L>::alignment, 1)) + block_traits<M, L>::size), ...);
+    return end;
+}
+
+template <typename... M>
+constexpr size_t Members<M...>::native_end() noexcept {
+    size_t end = 0;
+    ((end = align_up(end, alignof(M)) + sizeof(M)), ...);
+    return end;
+}
+
+template <typename... M>
+template <BlockLayout L>
+constexpr bool Members<M...>::matches() noexcept {
+    if (alignment<L>() == 0) {
+        return false;
+    }
+
+    bool matches = true;
+    size_t native = 0;
+    size_t block = 0;
+    ((native = align_up(native, alignof(M)),
+      block = align_up(block, block_traits<M, L>::alignment),
+      matches = matches && native == block && sizeof(M) == block_traits<M, L>::size,
+      native += sizeof(M),
+      block += block_traits<M, L>::size),
+     ...);
+    return matches;
+}
+
+/**
+ * Determine whether the native layout of structure <code>T</code> is
+ * identical to the specified block layout, so that instances can be copied
+ * to the GPU as is. The structure must declare all of its members in
+ * <code>T::layout</code>, see {@link Members}.
+ */
+template <typename T, BlockLayout L, typename = void>
+struct is_block_layout : std::false_type {};
+
+template <typename T, BlockLayout L>
+struct is_block_layout<T, L, std::enable_if_t<has_members<T>::value>>
+    : std::bool_constant<std::is_standard_layout<T>::value && std::is_trivially_copyable<T>::value &&
+                         block_traits<T, L>::members::template matches<L>() &&
+                         align_up(block_traits<T, L>::members::native_end(), alignof(T)) == sizeof(T)> {};
+}  // namespace gl
+
+#endif /* GLIMPSE_BLOCK_LAYOUT_H */
@@ -4,9 +4,13 @@
 #include <glimpse/gl.hpp>
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace gl {
+template <typename T>
+class MappedRange;
+
 /**
  * An untyped OpenGL buffer that is allocated on the GPU.
  * These can be used to store vertex data, pixel data retrieved from images or
@@ -23,24 +27,142 @@ public:
     enum class Type { STREAM, DYNAMIC, STATIC };
 
     /**
-     * Allocate a buffer with the specified reserved capacity.
+     * An enumeration of the usage flags of immutable buffer storage.
+     * The flags may be combined using <code>operator|</code>.
+     */
+    enum class Storage : unsigned {
+        /**
+         * The contents can only be changed by the GPU, e.g. through copies.
+         */
+        NONE = 0,
+        /**
+         * The contents may be updated through {@link Buffer#write}.
+         */
+        DYNAMIC_STORAGE = 1u << 0,
+        /**
+         * The buffer may be mapped for reading.
+         */
+        MAP_READ = 1u << 1,
+        /**
+         * The buffer may be mapped for writing.
+         */
+        MAP_WRITE = 1u << 2,
+        /**
+         * The buffer may stay mapped while the GPU uses it.
+         */
+        MAP_PERSISTENT = 1u << 3,
+        /**
+         * Persistent mappings are coherent between the CPU and the GPU.
+         */
+        MAP_COHERENT = 1u << 4,
+        /**
+         * Prefer placing the storage in client memory.
+         */
+        CLIENT_STORAGE = 1u << 5,
+    };
+
+    /**
+     * An enumeration of the access flags for mapping a range of the buffer.
+     * The flags may be combined using <code>operator|</code>.
+     */
+    enum class Access : unsigned {
+        /**
+         * The range may be read from.
+         */
+        READ = 1u << 0,
+        /**
+         * The range may be written to.
+         */
+        WRITE = 1u << 1,
+        /**
+         * The previous contents of the range may be discarded.
+         */
+        INVALIDATE_RANGE = 1u << 2,
+        /**
+         * The driver does not synchronize with pending operations on the buffer.
+         */
+        UNSYNCHRONIZED = 1u << 3,
+        /**
+         * Modifications are only made visible through {@link MappedRange#flush}.
+         */
+        FLUSH_EXPLICIT = 1u << 4,
+        /**
+         * The range may stay mapped while the GPU uses the buffer.
+         * Requires {@link Storage#MAP_PERSISTENT}.
+         */
+        PERSISTENT = 1u << 5,
+        /**
+         * The persistent mapping is coherent. Requires {@link Storage#MAP_COHERENT}.
+         */
+        COHERENT = 1u << 6,
+    };
+
+    /**
+     * An enumeration of the strategies used by {@link Buffer#write} to update
+     * a buffer that may still be read by in-flight commands.
+     */
+    enum class Update {
+        /**
+         * Update the buffer in place, which synchronizes with pending draws.
+         */
+        SUBDATA,
+        /**
+         * Detach the old storage before writing, by re-specifying mutable
+         * buffers or invalidating immutable ones.
+         */
+        ORPHAN,
+        /**
+         * Map the written range with invalidation and without synchronization.
+         * The caller guarantees that the GPU does not read the range anymore.
+         */
+        UNSYNCHRONIZED,
+        /**
+         * Rotate through a number of backing buffers, writing into the next
+         * backing buffer on every write.
+         */
+        ROUND_ROBIN,
+    };
+
+    /**
+     * An enumeration of the indexed targets a range of the buffer can be bound to.
+     */
+    enum class Target {
+        /**
+         * A uniform block.
+         */
+        UNIFORM,
+        /**
+         * A shader storage block.
+         */
+        SHADER_STORAGE,
+        /**
+         * Atomic counters.
+         */
+        ATOMIC_COUNTER,
+        /**
+         * The output of transform feedback.
+         */
+        TRANSFORM_FEEDBACK,
+    };
+
+    /**
+     * Allocate a buffer with the specified reserved capacity. The contents of
+     * the buffer are undefined until written.
      *
      * @param[in] reserve The capacity to reserve in bytes.
      * @param[in] type The type of buffer to allocate
      */
-    explicit Buffer(size_t reserve, Buffer::Type type = Buffer::Type::STATIC)
-        : Buffer(std::vector<char>(reserve), type) {}
+    explicit Buffer(size_t reserve, Buffer::Type type = Buffer::Type::STATIC) : Buffer(nullptr, reserve, type) {}
 
     /**
      * Allocate a buffer with the specified data.
      *
-     * @param[in] data The data to send to the GPU.
+     * @param[in] data The contiguous range of data to send to the GPU.
      * @param[in] type The type of buffer to allocate
      */
-    template <typename T>
-    explicit Buffer(const typename std::vector<T>& data,
-                    Buffer::Type type = Buffer::Type::STATIC)
-        : Buffer(data.data(), sizeof(T) * data.size(), type) {}
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    explicit Buffer(const R& data, Buffer::Type type = Buffer::Type::STATIC)
+        : Buffer(std::data(data), gl::size_bytes(data), type) {}
 
     /**
      * Allocate a buffer with the specified data.
@@ -53,6 +175,33 @@ public:
                     size_t size,
                     Buffer::Type type = Buffer::Type::STATIC);
 
+    /**
+     * Allocate an immutable buffer with the specified capacity. The contents
+     * of the buffer are undefined until written.
+     *
+     * @param[in] reserve The capacity to reserve in bytes.
+     * @param[in] storage The usage flags of the storage.
+     */
+    Buffer(size_t reserve, Buffer::Storage storage) : Buffer(nullptr, reserve, storage) {}
+
+    /**
+     * Allocate an immutable buffer with the specified data.
+     *
+     * @param[in] data The contiguous range of data to send to the GPU.
+     * @param[in] storage The usage flags of the storage.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    Buffer(const R& data, Buffer::Storage storage) : Buffer(std::data(data), gl::size_bytes(data), storage) {}
+
+    /**
+     * Allocate an immutable buffer with the specified data.
+     *
+     * @param[in] data The data to send to the GPU or <code>nullptr</code>.
+     * @param[in] size The size in bytes of the buffer.
+     * @param[in] storage The usage flags of the storage.
+     */
+    Buffer(const void* data, size_t size, Buffer::Storage storage);
+
     ~Buffer() noexcept;
 
     // Disable copy constructors
@@ -76,25 +225,55 @@ public:
     size_t size() const noexcept;
 
     /**
-     * The usage type of the buffer.
+     * The usage type of the buffer. Immutable buffers report {@link Type#STATIC}.
      */
     Buffer::Type type() const noexcept;
 
+    /**
+     * Determine whether the buffer has immutable storage.
+     */
+    bool immutable() const noexcept;
+
+    /**
+     * The usage flags of the immutable storage.
+     */
+    Buffer::Storage storage() const noexcept;
+
     /**
      * The reference to the native OpenGL handle of the buffer.
      */
     gl::Handle native_handle() const noexcept;
 
+    /**
+     * The strategy used to update the buffer.
+     */
+    Buffer::Update update() const noexcept;
+
+    /**
+     * Select the strategy used to update the buffer.
+     *
+     * With {@link Update#ROUND_ROBIN} the native handle changes on every write.
+     * Indexed bindings made through {@link #bind()} and {@link #bind_range()}
+     * are re-issued with the new handle, and vertex arrays, transform feedback
+     * objects and upload queues query the handle when they use the buffer.
+     * Code that keeps the native handle itself must query it again after
+     * every write. A round-robin write only carries over the bytes outside
+     * the written range from the previous backing buffer.
+     *
+     * @param[in] update The update strategy.
+     * @param[in] backings The number of backing buffers for {@link Update#ROUND_ROBIN}.
+     */
+    void set_update(Buffer::Update update, size_t backings = 3);
+
     /**
      * Write the specified data to the buffer.
      *
-     * @param[in] data The data to write to the buffer.
+     * @param[in] data The contiguous range of data to write to the buffer.
      * @param[in] offset The offset to write the data at.
      */
-    template <typename T>
-    void write(const typename std::vector<T>& data, int offset = 0) noexcept {
-        size_t size = sizeof(T) * data.size();
-        write(data.data(), size, offset);
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    void write(const R& data, int offset = 0) noexcept {
+        write(std::data(data), gl::size_bytes(data), offset);
     }
 
     /**
@@ -106,6 +285,21 @@ public:
      */
     void write(const void* data, size_t size, int offset = 0) noexcept;
 
+    /**
+     * Fill a range of the buffer with a byte value on the GPU, without
+     * staging any data on the host.
+     *
+     * @param[in] size The size in bytes of the range to fill.
+     * @param[in] offset The offset in bytes at which the range starts.
+     * @param[in] value The value to fill the range with.
+     */
+    void clear(size_t size, size_t offset = 0, unsigned char value = 0) noexcept;
+
+    /**
+     * Fill the whole buffer with zeros on the GPU.
+     */
+    void clear() noexcept { clear(m_size); }
+
     /**
      * Read the buffer from GPU memory.
      */
@@ -119,7 +313,107 @@ public:
      */
     std::vector<unsigned char> read(size_t size, int offset = 0) const;
 
+    /**
+     * Map a range of the buffer into client memory without copying it.
+     * The range is unmapped when the returned {@link MappedRange} is destroyed.
+     *
+     * @param[in] count The number of items of type <code>T</code> to map.
+     * @param[in] offset The offset in bytes at which the range starts.
+     * @param[in] access The access flags of the mapping.
+     */
+    template <typename T>
+    MappedRange<T> map(size_t count, size_t offset = 0, Buffer::Access access = Buffer::Access::READ);
+
+    /**
+     * Bind the whole buffer to an indexed binding point of the target.
+     *
+     * @param[in] target The target to bind the buffer to.
+     * @param[in] index The index of the binding point.
+     */
+    void bind(Buffer::Target target, unsigned index) const noexcept;
+
+    /**
+     * Bind a range of the buffer to an indexed binding point of the target.
+     * The offset must be a multiple of the offset alignment of the target.
+     *
+     * @param[in] target The target to bind the range to.
+     * @param[in] index The index of the binding point.
+     * @param[in] offset The offset in bytes at which the range starts.
+     * @param[in] size The size of the range in bytes.
+     */
+    void bind_range(Buffer::Target target, unsigned index, size_t offset, size_t size) const noexcept;
+
+    /**
+     * The alignment in bytes required for the offsets of ranges bound to the target.
+     *
+     * @param[in] target The target to query the alignment of.
+     */
+    static size_t offset_alignment(Buffer::Target target) noexcept;
+
 private:
+    template <typename T>
+    friend class MappedRange;
+    friend class ResourceLoader;
+
+    /**
+     * Adopt the specified buffer object and allocate its storage.
+     *
+     * @param[in] handle The buffer object to take ownership of.
+     * @param[in] data The data to send to the GPU or <code>nullptr</code>.
+     * @param[in] size The size in bytes of the buffer.
+     * @param[in] type The type of buffer to allocate
+     */
+    Buffer(gl::Handle handle, const void* data, size_t size, Buffer::Type type) noexcept;
+
+    /**
+     * Adopt the specified buffer object and allocate its immutable storage.
+     *
+     * @param[in] handle The buffer object to take ownership of.
+     * @param[in] data The data to send to the GPU or <code>nullptr</code>.
+     * @param[in] size The size in bytes of the buffer.
+     * @param[in] storage The usage flags of the storage.
+     */
+    Buffer(gl::Handle handle, const void* data, size_t size, Buffer::Storage storage);
+
+    /**
+     * Validate the combination of immutable storage flags.
+     */
+    static void validate(Buffer::Storage storage);
+
+    /**
+     * Map the specified range of the buffer.
+     *
+     * @param[in] offset The offset in bytes at which the range starts.
+     * @param[in] size The size of the range in bytes.
+     * @param[in] access The access flags of the mapping.
+     */
+    void* map_range(size_t offset, size_t size, Buffer::Access access) const;
+
+    /**
+     * Flush a subrange of a range mapped with {@link Access#FLUSH_EXPLICIT}.
+     *
+     * @param[in] handle The buffer object the range was mapped from.
+     * @param[in] offset The offset in bytes relative to the start of the mapped range.
+     * @param[in] size The size of the subrange in bytes.
+     */
+    static void flush_range(gl::Handle handle, size_t offset, size_t size) noexcept;
+
+    /**
+     * Unmap the currently mapped range of a buffer object.
+     *
+     * @param[in] handle The buffer object the range was mapped from.
+     */
+    static void unmap(gl::Handle handle) noexcept;
+
+    /**
+     * Allocate the storage of the specified buffer object with the size and
+     * usage of this buffer.
+     *
+     * @param[in] handle The buffer object to allocate storage for.
+     * @param[in] data The initial contents or <code>nullptr</code>.
+     */
+    void specify(gl::Handle handle, const void* data) const noexcept;
+
     /**
      * Reset the object state.
      */
@@ -135,7 +429,126 @@ private:
     gl::Handle m_handle{INVALID};
     size_t m_size{};
     Buffer::Type m_type;
+    bool m_immutable{false};
+    Buffer::Storage m_storage{Buffer::Storage::NONE};
+    Buffer::Update m_update{Buffer::Update::SUBDATA};
+    std::vector<gl::Handle> m_backings;
+    size_t m_backing{};
 };
+
+inline Buffer::Access operator|(Buffer::Access lhs, Buffer::Access rhs) noexcept {
+    return static_cast<Buffer::Access>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+inline Buffer::Storage operator|(Buffer::Storage lhs, Buffer::Storage rhs) noexcept {
+    return static_cast<Buffer::Storage>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+/**
+ * A typed view on a range of a {@link Buffer} that is mapped into client
+ * memory. The range is unmapped when the view is destroyed.
+ *
+ * Mapped ranges have unique ownership and may not be copied (only moved).
+ */
+template <typename T>
+class MappedRange {
+public:
+    using value_type = T;
+    using iterator = T*;
+
+    /**
+     * Construct an empty range that is not mapped.
+     */
+    MappedRange() noexcept = default;
+
+    ~MappedRange() noexcept { reset(); }
+
+    // Disable copy constructors
+    MappedRange(const MappedRange&) = delete;
+    MappedRange& operator=(const MappedRange&) = delete;
+
+    // Enable move constructors
+    MappedRange(MappedRange&& other) noexcept { swap(other); }
+    MappedRange& operator=(MappedRange&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    /**
+     * Determine whether the range is still mapped.
+     */
+    explicit operator bool() const noexcept { return m_data != nullptr; }
+
+    /**
+     * The pointer to the first item in the range.
+     */
+    T* data() const noexcept { return m_data; }
+
+    /**
+     * The number of items in the range.
+     */
+    size_t size() const noexcept { return m_count; }
+
+    /**
+     * The size of the range in bytes.
+     */
+    size_t size_bytes() const noexcept { return m_count * sizeof(T); }
+
+    T* begin() const noexcept { return m_data; }
+    T* end() const noexcept { return m_data + m_count; }
+    T& operator[](size_t index) const noexcept { return m_data[index]; }
+
+    /**
+     * Make modifications to a subrange visible to the GPU. Only meaningful for
+     * ranges mapped with {@link Buffer::Access#FLUSH_EXPLICIT}.
+     *
+     * @param[in] index The index of the first item to flush.
+     * @param[in] count The number of items to flush.
+     */
+    void flush(size_t index, size_t count) const noexcept {
+        Buffer::flush_range(m_handle, index * sizeof(T), count * sizeof(T));
+    }
+
+    /**
+     * Make modifications to the whole range visible to the GPU.
+     */
+    void flush() const noexcept { flush(0, m_count); }
+
+private:
+    friend class Buffer;
+
+    MappedRange(gl::Handle handle, T* data, size_t count) noexcept : m_handle(handle), m_data(data), m_count(count) {}
+
+    /**
+     * Reset the object state.
+     */
+    void reset() noexcept {
+        if (this->operator bool()) {
+            Buffer::unmap(m_handle);
+            m_data = nullptr;
+        }
+    }
+
+    /**
+     * Swap object state.
+     */
+    void swap(MappedRange& other) noexcept {
+        std::swap(m_handle, other.m_handle);
+        std::swap(m_data, other.m_data);
+        std::swap(m_count, other.m_count);
+    }
+
+    // The backing buffer that was mapped, which stays the same when a round-robin buffer rotates
+    gl::Handle m_handle{};
+    T* m_data{nullptr};
+    size_t m_count{};
+};
+
+template <typename T>
+MappedRange<T> Buffer::map(size_t count, size_t offset, Buffer::Access access) {
+    void* data = map_range(offset, sizeof(T) * count, access);
+    return MappedRange<T>(m_handle, static_cast<T*>(data), count);
+}
 }  // namespace gl
 
 #endif /* GLIMPSE_BUFFER_H */
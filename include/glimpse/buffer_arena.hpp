@@ -0,0 +1,173 @@
+#ifndef GLIMPSE_BUFFER_ARENA_H
+#define GLIMPSE_BUFFER_ARENA_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link BufferArena} sub-allocates many {@link Data} views out of a few
+ * large buffers, so that many meshes can share a single vertex buffer binding
+ * instead of each owning a separate OpenGL buffer object.
+ *
+ * Each block keeps its free ranges indexed both by offset (for coalescing
+ * neighbouring ranges on release) and by size (for logarithmic best-fit
+ * allocation). Requests that do not fit in any block allocate a new block.
+ */
+class BufferArena {
+public:
+    /**
+     * Statistics about the memory managed by the arena.
+     */
+    struct Statistics {
+        /**
+         * The number of blocks allocated.
+         */
+        size_t blocks;
+
+        /**
+         * The number of live allocations.
+         */
+        size_t allocations;
+
+        /**
+         * The total capacity of all blocks in bytes.
+         */
+        size_t capacity;
+
+        /**
+         * The number of bytes handed out to allocations.
+         */
+        size_t used;
+
+        /**
+         * The size of the largest free range in bytes.
+         */
+        size_t largest_free;
+
+        /**
+         * The fragmentation of the free space, between 0 (all free space is a
+         * single range) and 1 (free space is scattered over many small ranges).
+         */
+        double fragmentation() const noexcept {
+            size_t free = capacity - used;
+            return free == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free) / static_cast<double>(free);
+        }
+    };
+
+    /**
+     * Construct a buffer arena.
+     *
+     * @param[in] block_size The size in bytes of the blocks to allocate.
+     */
+    explicit BufferArena(size_t block_size = 16 * 1024 * 1024);
+
+    // Disable copy constructors
+    BufferArena(const BufferArena&) = delete;
+    BufferArena& operator=(const BufferArena&) = delete;
+
+    // Enable move constructors
+    BufferArena(BufferArena&&) noexcept = default;
+    BufferArena& operator=(BufferArena&&) noexcept = default;
+
+    /**
+     * The size in bytes of the blocks allocated by the arena.
+     */
+    size_t block_size() const noexcept;
+
+    /**
+     * Allocate an untyped range from the arena.
+     *
+     * @param[in] size The size of the range in bytes.
+     * @param[in] stride The size of the elements in the range.
+     * @param[in] descriptor The descriptor describing the contents of the range.
+     * @param[in] alignment The alignment of the start of the range in bytes (a power of two).
+     */
+    gl::Data allocate(size_t size, size_t stride, gl::ElementDescriptor descriptor, size_t alignment);
+
+    /**
+     * Allocate a range for <code>count</code> items of type <code>T</code>.
+     *
+     * @param[in] count The number of items to allocate.
+     * @param[in] alignment The alignment of the start of the range in bytes (a power of two).
+     */
+    template <typename T>
+    gl::TypedData<T> allocate(size_t count, size_t alignment = alignof(T)) {
+        auto [buffer, offset] = reserve(sizeof(T) * count, alignment);
+        return gl::TypedData<T>(std::move(buffer), std::slice(offset, sizeof(T) * count, sizeof(T)));
+    }
+
+    /**
+     * Allocate a range and upload the specified data into it.
+     *
+     * @param[in] data The contiguous range of data to send to the GPU.
+     * @param[in] alignment The alignment of the start of the range in bytes (a power of two).
+     */
+    template <typename R, typename T = gl::range_value_t<R>, typename = gl::enable_if_range_t<R>>
+    gl::TypedData<T> allocate(const R& data, size_t alignment = alignof(T)) {
+        gl::TypedData<T> view = allocate<T>(std::size(data), alignment);
+        view.buffer().write(std::data(data), gl::size_bytes(data), static_cast<int>(view.slice().start()));
+        return view;
+    }
+
+    /**
+     * Return a range to the arena. Other views of the range must not be used afterwards.
+     *
+     * @param[in] data The view that was returned by {@link #allocate}, which
+     * must cover exactly the allocated range and not a narrowed view of it.
+     */
+    void free(const gl::Data& data);
+
+    /**
+     * Release the blocks that do not contain any allocations.
+     */
+    void trim() noexcept;
+
+    /**
+     * Compute statistics about the memory managed by the arena.
+     */
+    Statistics statistics() const noexcept;
+
+private:
+    struct Block {
+        std::shared_ptr<gl::Buffer> buffer;
+        std::map<size_t, size_t> by_offset;
+        std::multimap<size_t, size_t> by_size;
+        std::map<size_t, size_t> allocations;
+        size_t used;
+    };
+
+    /**
+     * Reserve a range in one of the blocks, allocating a new block if necessary.
+     *
+     * @return The buffer of the block and the offset of the range within it.
+     */
+    std::pair<std::shared_ptr<gl::Buffer>, size_t> reserve(size_t size, size_t alignment);
+
+    /**
+     * Allocate a new block of at least the specified size.
+     */
+    Block& grow(size_t size);
+
+    /**
+     * Insert a free range into the block, coalescing it with its neighbours.
+     */
+    static void release(Block& block, size_t offset, size_t size);
+
+    /**
+     * Remove a free range from the size index of the block.
+     */
+    static void unlink(Block& block, size_t offset, size_t size) noexcept;
+
+    size_t m_block_size;
+    std::vector<Block> m_blocks;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_BUFFER_ARENA_H */
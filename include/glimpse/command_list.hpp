@@ -0,0 +1,138 @@
+#ifndef GLIMPSE_COMMAND_LIST_H
+#define GLIMPSE_COMMAND_LIST_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/framebuffer.hpp>
+#include <glimpse/uniform.hpp>
+#include <glimpse/vertex_array.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link CommandList} records rendering commands as a compact stream of
+ * plain data, so that commands can be built on any thread and replayed on the
+ * thread that owns the GL context.
+ *
+ * Recording issues no GL calls, so each worker thread records into its own
+ * list without synchronization. The commands are stored in a linear arena of
+ * fixed-size blocks owned by the list; {@link #clear()} rewinds the arena but
+ * keeps its blocks, so a list that is reused every frame stops allocating
+ * once it has grown to the size of a frame. The GL thread then replays the
+ * lists with {@link #execute()} in the order they should take effect.
+ *
+ * The recorded objects must stay alive until the list is executed.
+ */
+class CommandList {
+public:
+    /**
+     * Create an empty command list.
+     *
+     * @param[in] block_size The size in bytes of the blocks of the arena.
+     */
+    explicit CommandList(size_t block_size = 64 * 1024);
+
+    // Disable copy constructors
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+
+    // Enable move constructors
+    CommandList(CommandList&&) noexcept = default;
+    CommandList& operator=(CommandList&&) noexcept = default;
+
+    /**
+     * Record a draw of the vertex array, see {@link VertexArray#render()}.
+     */
+    void render(const gl::VertexArray& vertex_array,
+                unsigned mode,
+                int vertices = -1,
+                int first = 0,
+                int base_vertex = 0);
+
+    /**
+     * Record an instanced draw of the vertex array, see
+     * {@link VertexArray#render_instanced()}.
+     */
+    void render_instanced(const gl::VertexArray& vertex_array,
+                          unsigned mode,
+                          int vertices,
+                          int instances,
+                          unsigned base_instance = 0);
+
+    /**
+     * Record a write to a uniform. The value is copied into the list.
+     *
+     * @param[in] uniform The uniform to write.
+     * @param[in] value The value to write.
+     */
+    template <typename T>
+    void uniform(gl::Uniform& uniform, const T& value) {
+        record_uniform(uniform, gl::UniformBatch::type_index<T>(), &value, sizeof(T));
+    }
+
+    /**
+     * Record binding a texture to a texture unit.
+     *
+     * @param[in] unit The texture unit to bind the texture to.
+     * @param[in] texture The handle of the texture.
+     */
+    void bind_texture(unsigned unit, gl::Handle texture);
+
+    /**
+     * Record using a framebuffer as the target of the following draws, see
+     * {@link Framebuffer#use()}.
+     */
+    void use(gl::Framebuffer& framebuffer);
+
+    /**
+     * The number of recorded commands.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * The number of bytes used by the recorded commands.
+     */
+    size_t bytes() const noexcept;
+
+    /**
+     * Remove all commands, keeping the memory of the arena for reuse.
+     */
+    void clear() noexcept;
+
+    /**
+     * Replay the recorded commands in order. This must be called from the
+     * thread that owns the GL context, and not while the list is recorded.
+     */
+    void execute() const;
+
+private:
+    /**
+     * Record a write to a uniform of a value of the specified type, see
+     * {@link UniformBatch#type_index()}.
+     */
+    void record_uniform(gl::Uniform& uniform, unsigned type, const void* value, size_t size);
+
+    /**
+     * Allocate the specified number of bytes for a command at the end of the arena.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * A block of the arena.
+     */
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t capacity;
+        size_t used;
+    };
+
+    size_t m_block_size;
+    std::vector<Block> m_blocks;
+    size_t m_current{0};
+    size_t m_commands{0};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_COMMAND_LIST_H */
@@ -4,7 +4,11 @@
 #include <glimpse/gl.hpp>
 #include <glimpse/buffer.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 #include <valarray>
 #include <vector>
@@ -63,6 +67,23 @@ public:
                std::slice(0, reserve * element_size, element_size),
                descriptor) {}
 
+    /**
+     * Allocate an untyped immutable buffer with the specified reserved capacity.
+     *
+     * @param[in] reserve The capacity to reserve as the number of elements.
+     * @param[in] element_size The size of the elements in the buffer.
+     * @param[in] storage The usage flags of the immutable storage.
+     * @param[in] descriptor The descriptor describing the contents of the
+     * slice.
+     */
+    Data(size_t reserve,
+         size_t element_size,
+         gl::Buffer::Storage storage,
+         gl::ElementDescriptor descriptor = gl::ElementDescriptor::get<unsigned>())
+        : Data(std::make_shared<gl::Buffer>(reserve * element_size, storage),
+               std::slice(0, reserve * element_size, element_size),
+               descriptor) {}
+
     /**
      * Allocate an untyped buffer from the specified buffer.
      *
@@ -71,7 +92,7 @@ public:
      */
     template <typename T>
     explicit Data(gl::Buffer&& buffer, gl::ElementDescriptor descriptor = gl::ElementDescriptor::get<T>())
-        : Data(buffer, std::slice(0, buffer.size(), sizeof(T)), descriptor) {}
+        : Data(std::move(buffer), std::slice(0, buffer.size(), sizeof(T)), descriptor) {}
 
     /**
      * Allocate a buffer with the specified reserved capacity.
@@ -90,20 +111,71 @@ public:
     /**
      * Allocate a buffer with the specified data.
      *
-     * @param[in] data The data to send to the GPU.
+     * @param[in] data The contiguous range of data to send to the GPU.
      * @param[in] type The type of buffer to allocate
      * @param[in] descriptor The descriptor describing the contents of the slice.
      */
-    template <typename T>
-    explicit Data(const typename std::vector<T>& data,
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    explicit Data(const R& data,
                   gl::Buffer::Type type = gl::Buffer::Type::STATIC,
-                  gl::ElementDescriptor descriptor = gl::ElementDescriptor::get<T>())
-        : Data(std::move(gl::Buffer(data, type)), std::slice(0, data.size() * sizeof(T), sizeof(T)), descriptor) {}
+                  gl::ElementDescriptor descriptor = gl::ElementDescriptor::get<gl::range_value_t<R>>())
+        : Data(std::make_shared<gl::Buffer>(data, type),
+               std::slice(0, gl::size_bytes(data), sizeof(gl::range_value_t<R>)),
+               descriptor) {}
+
+    /**
+     * Allocate an immutable buffer with the specified data.
+     *
+     * @param[in] data The contiguous range of data to send to the GPU.
+     * @param[in] storage The usage flags of the immutable storage.
+     * @param[in] descriptor The descriptor describing the contents of the slice.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    Data(const R& data,
+         gl::Buffer::Storage storage,
+         gl::ElementDescriptor descriptor = gl::ElementDescriptor::get<gl::range_value_t<R>>())
+        : Data(std::make_shared<gl::Buffer>(data, storage),
+               std::slice(0, gl::size_bytes(data), sizeof(gl::range_value_t<R>)),
+               descriptor) {}
+
+    /**
+     * Allocate an index buffer with the narrowest index type that can hold
+     * the specified indices, i.e. 8, 16 or 32 bit. Indices of all ones are
+     * kept as primitive restart indices of the narrowed type.
+     *
+     * @param[in] indices The contiguous range of indices to send to the GPU.
+     * @param[in] type The type of buffer to allocate.
+     * @throws std::out_of_range A 64-bit index does not fit in 32 bits.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    static Data indices(const R& indices, gl::Buffer::Type type = gl::Buffer::Type::STATIC) {
+        using T = std::make_unsigned_t<gl::range_value_t<R>>;
+        static_assert(std::is_integral<gl::range_value_t<R>>::value, "Indices must be integers");
+
+        T max = 0;
+        for (auto index : indices) {
+            if (static_cast<T>(index) != std::numeric_limits<T>::max()) {
+                max = std::max(max, static_cast<T>(index));
+            }
+        }
+
+        // The largest value of each type is reserved for primitive restart
+        if (sizeof(T) > 1 && max < std::numeric_limits<std::uint8_t>::max()) {
+            return Data(narrow<std::uint8_t>(indices), type);
+        } else if (sizeof(T) > 2 && max < std::numeric_limits<std::uint16_t>::max()) {
+            return Data(narrow<std::uint16_t>(indices), type);
+        } else if (sizeof(T) > 4 && max < std::numeric_limits<std::uint32_t>::max()) {
+            return Data(narrow<std::uint32_t>(indices), type);
+        } else if (sizeof(T) > 4) {
+            throw std::out_of_range("Indices must fit in 32 bits");
+        }
+        return Data(indices, type);
+    }
 
     /**
      * The size of the buffer as the number of items of type <code>T</code>.
      */
-    size_t size() const noexcept { return m_buffer->size() / m_slice.stride(); }
+    size_t size() const noexcept { return m_slice.size() / m_slice.stride(); }
 
     /**
      * The underlying buffer that holds the data.
@@ -132,8 +204,8 @@ public:
      * @param[in] stride The stride between the elements.
      */
     Data select(size_t offset, size_t stride) const noexcept {
-        std::slice slice(offset, size(), stride);
-        return Data(m_buffer, slice);
+        std::slice slice(m_slice.start() + offset, m_slice.size(), stride);
+        return Data(m_buffer, slice).per_instance(m_divisor);
     }
 
     /**
@@ -142,13 +214,81 @@ public:
      * @param[in] descriptor The descriptor that describes the format of the elements.
      */
     Data reshape(gl::ElementDescriptor descriptor) const noexcept {
-        return Data(m_buffer, m_slice, descriptor);
+        return Data(m_buffer, m_slice, descriptor).per_instance(m_divisor);
+    }
+
+    /**
+     * The number of instances that share an element when the view sources a
+     * vertex attribute, or 0 if the attribute advances per vertex.
+     */
+    unsigned divisor() const noexcept { return m_divisor; }
+
+    /**
+     * Source a vertex attribute from this view per instance instead of per
+     * vertex.
+     *
+     * @param[in] divisor The number of instances that share an element.
+     */
+    Data per_instance(unsigned divisor = 1) const noexcept {
+        Data data(*this);
+        data.m_divisor = divisor;
+        return data;
+    }
+
+    /**
+     * Map the range of the buffer represented by this view into client memory.
+     * The view must be contiguous, i.e. its stride must equal the size of <code>T</code>.
+     *
+     * @param[in] access The access flags of the mapping.
+     */
+    template <typename T>
+    MappedRange<T> map(Buffer::Access access = Buffer::Access::READ) const {
+        if (m_slice.stride() != sizeof(T)) {
+            throw std::logic_error("Only contiguous views can be mapped");
+        }
+        return m_buffer->map<T>(m_slice.size() / sizeof(T), m_slice.start(), access);
+    }
+
+    /**
+     * Fill the range of the buffer represented by this view with a byte value on the GPU.
+     *
+     * @param[in] value The value to fill the range with.
+     */
+    void clear(unsigned char value = 0) noexcept { m_buffer->clear(m_slice.size(), m_slice.start(), value); }
+
+    /**
+     * Bind the range of the buffer represented by this view to an indexed
+     * binding point of the target. The start of the view must be a multiple of
+     * {@link Buffer#offset_alignment} for the target.
+     *
+     * @param[in] target The target to bind the range to.
+     * @param[in] index The index of the binding point.
+     */
+    void bind(Buffer::Target target, unsigned index) const noexcept {
+        m_buffer->bind_range(target, index, m_slice.start(), m_slice.size());
     }
 
 protected:
+    /**
+     * Convert indices to a narrower type, keeping primitive restart indices.
+     */
+    template <typename U, typename R>
+    static std::vector<U> narrow(const R& indices) {
+        using T = std::make_unsigned_t<gl::range_value_t<R>>;
+
+        std::vector<U> narrowed;
+        narrowed.reserve(std::size(indices));
+        for (auto index : indices) {
+            narrowed.push_back(static_cast<T>(index) == std::numeric_limits<T>::max() ? std::numeric_limits<U>::max()
+                                                                                     : static_cast<U>(index));
+        }
+        return narrowed;
+    }
+
     std::shared_ptr<gl::Buffer> m_buffer;
     std::slice m_slice;
     gl::ElementDescriptor m_descriptor;
+    unsigned m_divisor{0};
 };
 
 /**
@@ -157,8 +297,16 @@ protected:
  */
 template <typename T>
 class TypedData<T, typename std::enable_if_t<std::is_class<T>::value>> final : public Data {
+public:
     using Data::Data;
 
+    /**
+     * Map the range of the buffer represented by this view into client memory.
+     *
+     * @param[in] access The access flags of the mapping.
+     */
+    MappedRange<T> map(Buffer::Access access = Buffer::Access::READ) const { return Data::map<T>(access); }
+
 private:
     // XXX Hack to extract type of class member (requires C++17)
     template <auto value>
@@ -180,9 +328,12 @@ public:
         T* fake_container = reinterpret_cast<T*>(container_space);
         size_t offset =
             reinterpret_cast<uintptr_t>(&(fake_container->*member)) - reinterpret_cast<uintptr_t>(fake_container);
-        std::slice slice(offset, size(), sizeof(T));
+        std::slice slice(m_slice.start() + offset, m_slice.size(), sizeof(T));
         gl::ElementDescriptor descriptor = gl::ElementDescriptor::get<M>();
-        return TypedData<M>(m_buffer, slice, descriptor);
+        TypedData<M> data(m_buffer, slice, descriptor);
+        // Selected members advance at the same rate as the structure
+        static_cast<Data&>(data) = data.per_instance(m_divisor);
+        return data;
     }
 };
 
@@ -191,7 +342,15 @@ public:
  */
 template <typename T>
 class TypedData<T, typename std::enable_if_t<!std::is_class<T>::value>> final : public Data {
+public:
     using Data::Data;
+
+    /**
+     * Map the range of the buffer represented by this view into client memory.
+     *
+     * @param[in] access The access flags of the mapping.
+     */
+    MappedRange<T> map(Buffer::Access access = Buffer::Access::READ) const { return Data::map<T>(access); }
 };
 }  // namespace gl
 
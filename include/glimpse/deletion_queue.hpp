@@ -0,0 +1,129 @@
+#ifndef GLIMPSE_DELETION_QUEUE_H
+#define GLIMPSE_DELETION_QUEUE_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/fence.hpp>
+#include <glimpse/mpsc_queue.hpp>
+
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link DeletionQueue} defers the deletion of OpenGL objects until the GPU
+ * has finished the commands that may still reference them.
+ *
+ * Once a queue is installed, the objects of this library hand their handles
+ * to the queue when they are destroyed instead of deleting them directly.
+ * Handles may be released from any thread. Every call to {@link #collect()}
+ * on the GL thread retires the released handles behind a fence and deletes
+ * the handles of earlier frames whose fence has been signaled.
+ */
+class DeletionQueue {
+public:
+    /**
+     * An enumeration of the kinds of objects that can be deleted.
+     */
+    enum class Kind { BUFFER, TEXTURE, RENDERBUFFER, FRAMEBUFFER, VERTEX_ARRAY, PROGRAM, TRANSFORM_FEEDBACK, QUERY };
+
+    DeletionQueue() = default;
+
+    /**
+     * Uninstall the queue and delete all remaining handles once the GPU is
+     * done with them.
+     */
+    ~DeletionQueue() noexcept;
+
+    // Disable copy constructors
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+    /**
+     * Install the queue that receives the released handles, or
+     * <code>nullptr</code> to delete handles immediately.
+     *
+     * @param[in] queue The queue to install.
+     */
+    static void install(DeletionQueue* queue) noexcept;
+
+    /**
+     * The installed queue or <code>nullptr</code> if none is installed.
+     */
+    static DeletionQueue* installed() noexcept;
+
+    /**
+     * Release the specified handle through the installed queue, or delete it
+     * immediately if no queue is installed.
+     *
+     * @param[in] kind The kind of object.
+     * @param[in] handle The handle of the object.
+     */
+    static void release(Kind kind, gl::Handle handle) noexcept;
+
+    /**
+     * Queue the specified handle for deletion. This may be called from any thread.
+     *
+     * @param[in] kind The kind of object.
+     * @param[in] handle The handle of the object.
+     */
+    void enqueue(Kind kind, gl::Handle handle);
+
+    /**
+     * Retire the queued handles behind a fence and delete the handles whose
+     * fence has been signaled. This must be called once per frame from the
+     * thread that owns the GL context.
+     *
+     * @return The number of handles deleted.
+     */
+    size_t collect();
+
+    /**
+     * Wait for the GPU and delete all handles. This must be called from the
+     * thread that owns the GL context.
+     *
+     * @return The number of handles deleted.
+     */
+    size_t flush();
+
+    /**
+     * The number of handles waiting to be deleted.
+     */
+    size_t depth() const noexcept;
+
+    /**
+     * The number of handles whose fence has not been signaled yet.
+     */
+    size_t in_flight() const noexcept;
+
+private:
+    using Entry = std::pair<Kind, gl::Handle>;
+
+    struct Batch {
+        gl::Fence fence;
+        std::vector<Entry> handles;
+    };
+
+    /**
+     * Delete the specified handles, grouped by kind.
+     */
+    static void destroy(std::vector<Entry>& handles) noexcept;
+
+    /**
+     * Delete the specified handles of a single kind.
+     */
+    static void destroy(Kind kind, const gl::Handle* names, size_t count) noexcept;
+
+    /**
+     * Retire the queued handles behind a fence.
+     */
+    void retire();
+
+    gl::MpscQueue<Entry> m_queue;
+    std::deque<Batch> m_batches;
+    std::atomic<size_t> m_in_flight{0};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_DELETION_QUEUE_H */
@@ -0,0 +1,111 @@
+#ifndef GLIMPSE_DRAW_INDIRECT_BUFFER_H
+#define GLIMPSE_DRAW_INDIRECT_BUFFER_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace gl {
+class VertexArray;
+
+/**
+ * The parameters of a non-indexed draw sourced from a buffer.
+ */
+struct DrawArraysIndirectCommand {
+    unsigned count;
+    unsigned instance_count;
+    unsigned first;
+    unsigned base_instance;
+};
+
+/**
+ * The parameters of an indexed draw sourced from a buffer. The first index
+ * counts from the start of the buffer that holds the indices.
+ */
+struct DrawElementsIndirectCommand {
+    unsigned count;
+    unsigned instance_count;
+    unsigned first_index;
+    int base_vertex;
+    unsigned base_instance;
+};
+
+/**
+ * A {@link DrawIndirectBuffer} collects draw commands on the CPU and submits
+ * them to the GPU with a single multi-draw call, e.g. to draw thousands of
+ * meshes that share the vertex and index buffers of a {@link VertexArray}.
+ *
+ * The commands are uploaded to the GPU in one write when they are submitted
+ * after a change.
+ */
+class DrawIndirectBuffer {
+public:
+    /**
+     * Construct an empty command buffer.
+     *
+     * @param[in] capacity The number of commands to reserve space for.
+     */
+    explicit DrawIndirectBuffer(size_t capacity = 256);
+
+    /**
+     * Append an indexed draw command.
+     *
+     * @param[in] command The command to append.
+     */
+    void add(const DrawElementsIndirectCommand& command);
+
+    /**
+     * Append a non-indexed draw command.
+     *
+     * @param[in] command The command to append.
+     */
+    void add(const DrawArraysIndirectCommand& command);
+
+    /**
+     * Remove all commands, keeping the allocated memory.
+     */
+    void clear() noexcept;
+
+    /**
+     * The number of commands in the buffer.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * Upload the commands to the GPU if they changed since the last upload.
+     */
+    void upload();
+
+    /**
+     * The view on the uploaded indexed draw commands.
+     */
+    gl::TypedData<DrawElementsIndirectCommand> elements() const;
+
+    /**
+     * The view on the uploaded non-indexed draw commands.
+     */
+    gl::TypedData<DrawArraysIndirectCommand> arrays() const;
+
+    /**
+     * Upload the commands if needed and draw them from the vertex array, with
+     * one call for the indexed and one call for the non-indexed commands.
+     *
+     * @param[in] vertex_array The vertex array to draw.
+     * @param[in] mode The rendering mode to use.
+     */
+    void submit(const gl::VertexArray& vertex_array, unsigned mode);
+
+private:
+    std::vector<DrawElementsIndirectCommand> m_elements;
+    std::vector<DrawArraysIndirectCommand> m_arrays;
+    std::shared_ptr<gl::Buffer> m_buffer;
+    size_t m_uploaded_elements{};
+    size_t m_uploaded_arrays{};
+    bool m_dirty{false};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_DRAW_INDIRECT_BUFFER_H */
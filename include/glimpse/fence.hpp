@@ -0,0 +1,80 @@
+#ifndef GLIMPSE_FENCE_H
+#define GLIMPSE_FENCE_H
+
+#include <glimpse/gl.hpp>
+
+#include <cstdint>
+
+namespace gl {
+/**
+ * A {@link Fence} is a synchronization object that is inserted into the OpenGL
+ * command stream and becomes signaled once the GPU has processed all commands
+ * issued before it.
+ *
+ * Fences have unique ownership and may not be copied (only moved).
+ */
+class Fence {
+public:
+    /**
+     * Construct an empty fence that is not associated with any sync object.
+     */
+    Fence() noexcept = default;
+
+    /**
+     * Insert a new fence into the OpenGL command stream.
+     */
+    static Fence insert();
+
+    ~Fence() noexcept;
+
+    // Disable copy constructors
+    Fence(const Fence&) = delete;
+    Fence& operator=(const Fence&) = delete;
+
+    // Enable move constructors
+    Fence(Fence&&) noexcept;
+    Fence& operator=(Fence&&) noexcept;
+
+    Fence& operator=(std::nullptr_t);
+
+    /**
+     * Determine whether the fence is associated with a sync object.
+     */
+    explicit operator bool() const noexcept;
+
+    /**
+     * Determine whether the GPU has passed the fence without blocking.
+     */
+    bool signaled() const;
+
+    /**
+     * Block until the GPU has passed the fence or the timeout expires.
+     *
+     * @param[in] timeout The timeout in nanoseconds.
+     * @return <code>true</code> if the fence was signaled, <code>false</code> if the timeout expired.
+     */
+    bool wait(std::uint64_t timeout = UINT64_MAX) const;
+
+    /**
+     * The native OpenGL sync object.
+     */
+    void* native_handle() const noexcept;
+
+private:
+    explicit Fence(void* sync) noexcept;
+
+    /**
+     * Reset the object state.
+     */
+    void reset() noexcept;
+
+    /**
+     * Swap object state.
+     */
+    void swap(Fence& other) noexcept;
+
+    void* m_sync{nullptr};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_FENCE_H */
@@ -158,6 +158,11 @@ private:
 
     void clear(const glm::vec4& color, float depth, const glm::ivec4* viewport) noexcept;
 
+    /**
+     * Set the color and depth write masks for the attachments.
+     */
+    void set_masks() const noexcept;
+
     static constexpr gl::Handle INVALID = 0xFFFFFFFF;
 
     gl::Handle m_handle{INVALID};
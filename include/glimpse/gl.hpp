@@ -6,10 +6,45 @@
 
 #include <array>
 #include <exception>
+#include <iterator>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace gl {
+/**
+ * Determine whether <code>R</code> is a contiguous range, i.e. a type for which
+ * <code>std::data</code> and <code>std::size</code> are defined, such as
+ * <code>std::vector</code>, <code>std::array</code> or a C array.
+ */
+template <typename R, typename = void>
+struct is_contiguous_range : std::false_type {};
+
+template <typename R>
+struct is_contiguous_range<R,
+                           std::void_t<decltype(std::data(std::declval<const R&>())),
+                                       decltype(std::size(std::declval<const R&>()))>> : std::true_type {};
+
+/**
+ * The type of the elements of the contiguous range <code>R</code>.
+ */
+template <typename R>
+using range_value_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<const R&>()))>>;
+
+/**
+ * Restrict an overload to contiguous ranges.
+ */
+template <typename R>
+using enable_if_range_t = std::enable_if_t<is_contiguous_range<R>::value>;
+
+/**
+ * The size in bytes of the contiguous range.
+ */
+template <typename R, typename = enable_if_range_t<R>>
+size_t size_bytes(const R& range) noexcept {
+    return sizeof(range_value_t<R>) * std::size(range);
+}
 
 /**
  * An {@link ElementDescriptor} describes an element in a buffer.
@@ -0,0 +1,86 @@
+#ifndef GLIMPSE_MPSC_QUEUE_H
+#define GLIMPSE_MPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace gl {
+/**
+ * A lock-free queue with multiple producers and a single consumer.
+ *
+ * Producers push items onto an intrusive stack with a single compare-and-swap.
+ * The consumer takes the whole stack at once with an atomic exchange and
+ * reverses it, so items are drained in the order they were pushed by each
+ * producer.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() noexcept = default;
+
+    ~MpscQueue() noexcept {
+        Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    // Disable copy and move constructors
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * Push an item onto the queue. This may be called from any thread.
+     *
+     * @param[in] value The item to push.
+     */
+    void push(T value) {
+        Node* node = new Node{std::move(value), m_head.load(std::memory_order_relaxed)};
+
+        // Count the item before publishing it, so a drain that takes it never decrements below zero
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Take all items from the queue in the order they were pushed. This may
+     * only be called from the consuming thread.
+     */
+    std::vector<T> drain() {
+        Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+        std::vector<T> items;
+        while (node) {
+            Node* next = node->next;
+            items.push_back(std::move(node->value));
+            delete node;
+            node = next;
+        }
+
+        m_size.fetch_sub(items.size(), std::memory_order_relaxed);
+        std::reverse(items.begin(), items.end());
+        return items;
+    }
+
+    /**
+     * The approximate number of items in the queue.
+     */
+    size_t size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> m_head{nullptr};
+    std::atomic<size_t> m_size{0};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_MPSC_QUEUE_H */
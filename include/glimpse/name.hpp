@@ -0,0 +1,70 @@
+#ifndef GLIMPSE_NAME_H
+#define GLIMPSE_NAME_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace gl {
+/**
+ * A {@link Name} is the name of a program member along with its hash, so that
+ * members can be looked up without hashing or allocating on the hot path.
+ *
+ * The hash of a name known at compile time is computed by the compiler:
+ *
+ * <pre>
+ * using namespace gl::literals;
+ * static constexpr gl::Name MVP = "mvp"_name;
+ * gl::UniformHandle mvp = program.uniform(MVP);
+ * </pre>
+ *
+ * The name must outlive the {@link Name}, which is the case for literals.
+ */
+class Name {
+public:
+    constexpr Name(const char* name) noexcept : Name(std::string_view(name)) {}
+
+    constexpr Name(std::string_view name) noexcept : m_name(name), m_hash(fnv1a(name)) {}
+
+    Name(const std::string& name) noexcept : Name(std::string_view(name)) {}
+
+    /**
+     * The name.
+     */
+    constexpr std::string_view str() const noexcept { return m_name; }
+
+    /**
+     * The 64-bit FNV-1a hash of the name.
+     */
+    constexpr std::uint64_t hash() const noexcept { return m_hash; }
+
+    /**
+     * Compute the 64-bit FNV-1a hash of a string.
+     *
+     * @param[in] value The string to hash.
+     * @param[in] hash The hash to continue from, so that several values can be
+     * hashed in sequence.
+     */
+    static constexpr std::uint64_t fnv1a(std::string_view value, std::uint64_t hash = 0xcbf29ce484222325) noexcept {
+        for (char c : value) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+        }
+        return hash;
+    }
+
+private:
+    std::string_view m_name;
+    std::uint64_t m_hash;
+};
+
+namespace literals {
+/**
+ * Create a {@link Name} whose hash is computed at compile time.
+ */
+constexpr gl::Name operator""_name(const char* name, size_t length) noexcept {
+    return gl::Name(std::string_view(name, length));
+}
+}  // namespace literals
+}  // namespace gl
+
+#endif /* GLIMPSE_NAME_H */
@@ -3,14 +3,33 @@
 
 #include <glimpse/gl.hpp>
 #include <glimpse/attribute.hpp>
+#include <glimpse/barrier.hpp>
+#include <glimpse/block.hpp>
+#include <glimpse/data.hpp>
+#include <glimpse/name.hpp>
+#include <glimpse/program_cache.hpp>
 #include <glimpse/uniform.hpp>
 
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace gl {
+/**
+ * The parameters of a dispatch sourced from a buffer by
+ * {@link Program#dispatch_indirect}: the number of work groups in each
+ * dimension.
+ */
+struct DispatchIndirectCommand {
+    unsigned x;
+    unsigned y;
+    unsigned z;
+};
+
 /**
  * An exception that is thrown when a program fails to load.
  */
@@ -56,16 +75,113 @@ public:
      */
     std::unordered_map<std::string, gl::Uniform> uniforms;
 
+    /**
+     * The uniform blocks of the program.
+     */
+    std::unordered_map<std::string, gl::Block> uniform_blocks;
+
+    /**
+     * The shader storage blocks of the program.
+     */
+    std::unordered_map<std::string, gl::Block> storage_blocks;
+
+    /**
+     * Resolve a uniform without hashing or allocating a string, e.g. once
+     * after the program was built.
+     *
+     * @param[in] name The name of the uniform.
+     * @return A handle to the uniform, which ignores writes if the program has
+     * no such active uniform.
+     */
+    gl::UniformHandle uniform(gl::Name name) noexcept;
+
+    /**
+     * Resolve an attribute without hashing or allocating a string.
+     *
+     * @param[in] name The name of the attribute.
+     * @return The attribute, or <code>nullptr</code> if the program has no
+     * such active attribute.
+     */
+    const gl::Attribute* attribute(gl::Name name) const noexcept;
+
+    /**
+     * Obtain statistics about the writes to the uniforms of the program,
+     * including the writes skipped because the value was unchanged.
+     */
+    gl::UniformShadow::Statistics uniform_statistics() const noexcept;
+
+    /**
+     * Forget the values of the uniforms, so that the next write of each
+     * uniform is issued, e.g. after they were written behind the back of the
+     * library.
+     */
+    void invalidate_uniforms() noexcept;
+
     /**
      * Use the program.
      */
     void use() const noexcept;
 
+    /**
+     * The local work group size of a compute program.
+     */
+    glm::uvec3 work_group_size() const noexcept;
+
+    /**
+     * Launch work groups of a compute program.
+     *
+     * @param[in] x The number of work groups in the X dimension.
+     * @param[in] y The number of work groups in the Y dimension.
+     * @param[in] z The number of work groups in the Z dimension.
+     * @param[in] barrier The ways in which the results are consumed by later
+     * commands, which are ordered after the dispatch with a memory barrier.
+     */
+    void dispatch(unsigned x, unsigned y = 1, unsigned z = 1, gl::Barrier barrier = gl::Barrier::NONE) const noexcept;
+
+    /**
+     * Launch work groups of a compute program with the number of groups
+     * sourced from a buffer, e.g. written by an earlier dispatch.
+     *
+     * @param[in] commands The view on the buffer holding {@link DispatchIndirectCommand}s.
+     * @param[in] index The index of the command to use.
+     * @param[in] barrier The ways in which the results are consumed by later
+     * commands, which are ordered after the dispatch with a memory barrier.
+     */
+    void dispatch_indirect(const gl::Data& commands,
+                           size_t index = 0,
+                           gl::Barrier barrier = gl::Barrier::NONE) const;
+
 private:
     friend class ProgramBuilder;
-    Program(gl::Handle handle);
+    friend class ProgramCache;
+    friend class PendingProgram;
+
+    /**
+     * Take ownership of a linked program.
+     *
+     * @param[in] handle The handle of the program.
+     * @param[in] reflect Query the uniforms, attributes and blocks of the program.
+     */
+    Program(gl::Handle handle, bool reflect = true);
 
 private:
+    /**
+     * Query the uniforms, attributes and blocks of the linked program.
+     */
+    void reflect();
+
+    /**
+     * Build the tables of uniforms and attributes sorted by the hash of their
+     * name, and the shadow of the uniform values.
+     */
+    void index();
+
+    /**
+     * Find the entry with the specified name in a table built by {@link #index()}.
+     */
+    template <typename T>
+    static T* find(const std::vector<std::pair<std::uint64_t, T*>>& table, gl::Name name) noexcept;
+
     /**
      * Reset the object state.
      */
@@ -79,6 +195,74 @@ private:
     static constexpr gl::Handle INVALID = 0xFFFFFFFF;
 
     gl::Handle m_handle{INVALID};
+    std::vector<std::pair<std::uint64_t, gl::Uniform*>> m_uniform_table;
+    std::vector<std::pair<std::uint64_t, const gl::Attribute*>> m_attribute_table;
+    std::unique_ptr<gl::UniformShadow> m_uniform_shadow;
+};
+
+/**
+ * A {@link PendingProgram} is a program whose stages are still being compiled
+ * and linked by the driver, see {@link ProgramBuilder#build_async()}.
+ *
+ * With <code>GL_KHR_parallel_shader_compile</code>, the driver compiles and
+ * links in background threads, and {@link #ready()} reports whether it has
+ * finished without waiting for it. Submitting many programs before obtaining
+ * any of them lets the driver work on all of them at once.
+ */
+class PendingProgram {
+public:
+    ~PendingProgram() noexcept;
+
+    // Disable copy constructors
+    PendingProgram(const PendingProgram&) = delete;
+    PendingProgram& operator=(const PendingProgram&) = delete;
+
+    // Enable move constructors
+    PendingProgram(PendingProgram&&) noexcept = default;
+    PendingProgram& operator=(PendingProgram&&) noexcept;
+
+    /**
+     * Determine whether the program can be obtained without waiting for the
+     * driver. Without <code>GL_KHR_parallel_shader_compile</code>, this is
+     * always true and {@link #get()} waits instead.
+     */
+    bool ready() const noexcept;
+
+    /**
+     * Obtain the program, waiting for the driver to finish compiling and
+     * linking it. This may only be called once.
+     *
+     * @throws ProgramLoadingException A stage failed to compile or the program failed to link.
+     * @throws std::logic_error The program was already obtained.
+     */
+    gl::Program get();
+
+private:
+    friend class ProgramBuilder;
+
+    /**
+     * Wrap a program that was loaded from a cache.
+     */
+    explicit PendingProgram(gl::Program program) noexcept;
+
+    /**
+     * Wrap a program that is being linked from the specified stages.
+     */
+    PendingProgram(gl::Program program,
+                   std::vector<unsigned> stages,
+                   std::shared_ptr<gl::ProgramCache> cache,
+                   std::uint64_t key) noexcept;
+
+    /**
+     * Delete the compiled stages.
+     */
+    void free_stages() noexcept;
+
+    gl::Program m_program;
+    std::vector<unsigned> m_stages;
+    std::shared_ptr<gl::ProgramCache> m_cache;
+    std::uint64_t m_key{0};
+    bool m_pending{false};
 };
 
 /**
@@ -89,7 +273,6 @@ public:
     ProgramBuilder() = default;
     ProgramBuilder(const ProgramBuilder&) = delete;
     ProgramBuilder(ProgramBuilder&&) = default;
-    ~ProgramBuilder();
 
     /**
      * Add a stage to the program to construct.
@@ -100,15 +283,63 @@ public:
     ProgramBuilder& add_stage(unsigned stage, std::filesystem::path path);
 
     /**
-     * Build a program from the loaded stages.
+     * Add a stage to the program to construct from its source code.
+     *
+     * @param[in] stage The stage of the shader.
+     * @param[in] source The source code of the shader.
+     */
+    ProgramBuilder& add_source(unsigned stage, const std::string& source);
+
+    /**
+     * Capture the specified output variables with transform feedback, see
+     * {@link TransformFeedback}.
+     *
+     * @param[in] varyings The names of the output variables to capture.
+     * @param[in] interleaved Capture all variables into a single buffer
+     * instead of one buffer per variable.
+     */
+    ProgramBuilder& capture(std::vector<std::string> varyings, bool interleaved = true);
+
+    /**
+     * Load the program from a cache of program binaries if possible, and
+     * store it in the cache after it was built otherwise.
+     *
+     * @param[in] cache The cache to use.
+     */
+    ProgramBuilder& cache(std::shared_ptr<gl::ProgramCache> cache);
+
+    /**
+     * Build a program from the loaded stages. The stages are compiled here,
+     * unless the program is loaded from the cache.
      */
     Program build();
 
-private:
-    void freeStages();
+    /**
+     * Submit the loaded stages for compilation and linking without waiting
+     * for the driver to finish, see {@link PendingProgram}.
+     */
+    PendingProgram build_async();
+
+    /**
+     * Determine whether the driver supports compiling and linking in
+     * background threads (<code>GL_KHR_parallel_shader_compile</code>).
+     */
+    static bool parallel_compile() noexcept;
+
+    /**
+     * Set the number of background threads the driver may use to compile and
+     * link, if parallel compilation is supported.
+     *
+     * @param[in] count The maximum number of threads, or 0xFFFFFFFF to let
+     * the driver decide.
+     */
+    static void set_compiler_threads(unsigned count) noexcept;
 
 private:
-    std::vector<unsigned> m_stages;
+    std::vector<std::pair<unsigned, std::string>> m_sources;
+    std::vector<std::string> m_varyings;
+    bool m_interleaved{true};
+    std::shared_ptr<gl::ProgramCache> m_cache;
 };
 }  // namespace gl
 
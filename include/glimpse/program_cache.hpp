@@ -0,0 +1,106 @@
+#ifndef GLIMPSE_PROGRAM_CACHE_H
+#define GLIMPSE_PROGRAM_CACHE_H
+
+#include <glimpse/gl.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gl {
+class Program;
+
+/**
+ * A {@link ProgramCache} stores linked program binaries on disk, so that
+ * later runs can skip compiling and linking, see {@link ProgramBuilder#cache()}.
+ *
+ * Binaries are keyed by a hash of the stage types and sources, the transform
+ * feedback varyings and the vendor, renderer and version of the driver. The
+ * reflected uniforms, attributes and blocks are stored next to the binary, so
+ * loading a program does not query them again. A binary that the driver
+ * rejects, e.g. after a driver update, is removed and the program is built
+ * from source instead.
+ */
+class ProgramCache {
+public:
+    /**
+     * Statistics about the lookups of the cache.
+     */
+    struct Statistics {
+        /**
+         * The number of programs loaded from the cache.
+         */
+        size_t hits;
+
+        /**
+         * The number of programs that had to be built from source.
+         */
+        size_t misses;
+    };
+
+    /**
+     * Open a program cache. This must be called from the thread that owns
+     * the GL context.
+     *
+     * @param[in] directory The directory holding the binaries, which is
+     * created if it does not exist.
+     */
+    explicit ProgramCache(std::filesystem::path directory);
+
+    /**
+     * The directory holding the binaries.
+     */
+    const std::filesystem::path& directory() const noexcept;
+
+    /**
+     * Obtain statistics about the lookups of the cache.
+     */
+    Statistics statistics() const noexcept;
+
+    /**
+     * Determine whether the driver supports at least one program binary
+     * format. Without one, every lookup misses.
+     */
+    static bool supported() noexcept;
+
+private:
+    friend class ProgramBuilder;
+    friend class PendingProgram;
+
+    /**
+     * Compute the key of a program.
+     *
+     * @param[in] sources The stage types and sources of the program.
+     * @param[in] varyings The captured transform feedback varyings.
+     * @param[in] interleaved Whether the varyings are interleaved.
+     */
+    std::uint64_t key(const std::vector<std::pair<unsigned, std::string>>& sources,
+                      const std::vector<std::string>& varyings,
+                      bool interleaved) const noexcept;
+
+    /**
+     * Load the program with the specified key, if it is cached and accepted
+     * by the driver.
+     */
+    std::optional<gl::Program> load(std::uint64_t key);
+
+    /**
+     * Store the binary and the reflected interface of a linked program.
+     */
+    void store(std::uint64_t key, const gl::Program& program) const;
+
+    /**
+     * The path of the binary with the specified key.
+     */
+    std::filesystem::path path(std::uint64_t key) const;
+
+    std::filesystem::path m_directory;
+    std::uint64_t m_driver;
+    Statistics m_statistics{};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_PROGRAM_CACHE_H */
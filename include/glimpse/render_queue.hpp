@@ -0,0 +1,197 @@
+#ifndef GLIMPSE_RENDER_QUEUE_H
+#define GLIMPSE_RENDER_QUEUE_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/framebuffer.hpp>
+#include <glimpse/uniform.hpp>
+#include <glimpse/vertex_array.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link RenderQueue} collects the draws of a frame as packets and submits
+ * them in an order that minimizes state changes.
+ *
+ * Every packet receives a 64-bit sort key made of, from most to least
+ * significant, its layer, framebuffer, program, vertex array, first texture
+ * and depth. The keys are radix sorted when the queue is flushed, so packets
+ * sharing a framebuffer, program or vertex array are submitted next to each
+ * other. The sort is stable, so packets with equal keys keep their order.
+ */
+class RenderQueue {
+public:
+    /**
+     * A texture bound to a texture unit before a packet is drawn.
+     */
+    struct TextureBinding {
+        unsigned unit;
+        gl::Handle texture;
+    };
+
+    /**
+     * A draw of a vertex array.
+     */
+    struct Packet {
+        /**
+         * The vertex array to draw, which determines the program.
+         */
+        const gl::VertexArray* vertex_array;
+
+        /**
+         * The rendering mode to use.
+         */
+        unsigned mode;
+
+        /**
+         * The number of vertices to render, or -1 to render the remaining vertices.
+         */
+        int vertices{-1};
+
+        /**
+         * The index of the first index or vertex to render.
+         */
+        int first{0};
+
+        /**
+         * The value added to every index before fetching the vertex.
+         */
+        int base_vertex{0};
+
+        /**
+         * The framebuffer to render to, or <code>nullptr</code> to render to
+         * the framebuffer of the previously submitted packet. Packets
+         * submitted before the first packet that sets a framebuffer render
+         * to the framebuffer bound when the queue is flushed, and are drawn
+         * before all other packets.
+         */
+        gl::Framebuffer* framebuffer{nullptr};
+
+        /**
+         * The layer of the packet, e.g. to draw opaque before transparent
+         * geometry. Lower layers are drawn first.
+         */
+        std::uint8_t layer{0};
+
+        /**
+         * The normalized depth in [0, 1] used to order packets that share all
+         * bindings, e.g. front to back.
+         */
+        float depth{0.0f};
+    };
+
+    /**
+     * Statistics about the last flush of the queue.
+     */
+    struct Statistics {
+        /**
+         * The number of packets submitted.
+         */
+        size_t packets;
+
+        /**
+         * The number of framebuffer, program, vertex array and texture
+         * switches in the sorted order.
+         */
+        size_t switches;
+
+        /**
+         * The number of switches the packets would have caused in the order
+         * in which they were recorded.
+         */
+        size_t unsorted_switches;
+
+        /**
+         * The number of switches saved by sorting.
+         */
+        size_t saved() const noexcept { return unsorted_switches > switches ? unsorted_switches - switches : 0; }
+    };
+
+    RenderQueue() = default;
+
+    // Disable copy constructors
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Enable move constructors
+    RenderQueue(RenderQueue&&) noexcept = default;
+    RenderQueue& operator=(RenderQueue&&) noexcept = default;
+
+    /**
+     * Record a packet.
+     *
+     * @param[in] packet The draw to record.
+     * @param[in] textures The textures to bind before drawing.
+     * @param[in] uniforms The writes to the uniforms of the program of the
+     * vertex array to apply before drawing, or <code>nullptr</code>. The batch
+     * is not copied and must stay alive until the queue is flushed.
+     */
+    void submit(const Packet& packet,
+                std::initializer_list<TextureBinding> textures = {},
+                const gl::UniformBatch* uniforms = nullptr);
+
+    /**
+     * The number of recorded packets.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * Sort the recorded packets, draw them and clear the queue. This must be
+     * called from the thread that owns the GL context.
+     *
+     * @return The statistics of the flush.
+     */
+    Statistics flush();
+
+    /**
+     * The statistics of the last flush.
+     */
+    Statistics statistics() const noexcept;
+
+private:
+    /**
+     * A recorded packet along with its bindings.
+     */
+    struct Record {
+        Packet packet;
+        gl::Framebuffer* framebuffer;
+        std::uint32_t first_texture;
+        std::uint32_t num_textures;
+        const gl::UniformBatch* uniforms;
+    };
+
+    /**
+     * Compute the sort keys of the recorded packets.
+     */
+    void compute_keys();
+
+    /**
+     * Sort a range of the order of the packets by their keys.
+     *
+     * @param[in] first The index of the first packet of the range.
+     * @param[in] last The index after the last packet of the range.
+     */
+    void sort(size_t first, size_t last);
+
+    /**
+     * Count the binding switches of drawing the packets in the specified order.
+     */
+    size_t count_switches(const std::vector<std::uint32_t>& order) const;
+
+    static constexpr gl::Handle INVALID = 0xFFFFFFFF;
+
+    std::vector<Record> m_records;
+    gl::Framebuffer* m_framebuffer{nullptr};
+    size_t m_leading{0};
+    std::vector<TextureBinding> m_textures;
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint32_t> m_order;
+    std::vector<std::uint64_t> m_scratch_keys;
+    std::vector<std::uint32_t> m_scratch_order;
+    Statistics m_statistics{};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_RENDER_QUEUE_H */
@@ -0,0 +1,156 @@
+#ifndef GLIMPSE_RESOURCE_LOADER_H
+#define GLIMPSE_RESOURCE_LOADER_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/mpsc_queue.hpp>
+#include <glimpse/program.hpp>
+#include <glimpse/texture.hpp>
+
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link ResourceLoader} lets worker threads prepare buffers, textures and
+ * programs without a GL context.
+ *
+ * Requests are recorded as descriptors that take ownership of their CPU data
+ * by move and are handed to the GL thread through lock-free queues. The GL
+ * thread creates the requested objects in batches in {@link #materialize()},
+ * e.g. with a single <code>glCreateBuffers</code> call for all pending
+ * buffers. The requesting thread receives a future that becomes ready once
+ * the object exists.
+ */
+class ResourceLoader {
+public:
+    ResourceLoader() = default;
+
+    // Disable copy constructors
+    ResourceLoader(const ResourceLoader&) = delete;
+    ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+    /**
+     * Request a buffer with the specified data. This may be called from any thread.
+     *
+     * @param[in] data The data to send to the GPU, which is moved into the request.
+     * @param[in] type The type of buffer to allocate.
+     */
+    template <typename T>
+    std::shared_future<std::shared_ptr<gl::Buffer>> buffer(std::vector<T> data,
+                                                            gl::Buffer::Type type = gl::Buffer::Type::STATIC) {
+        BufferRequest request = make_request(std::move(data));
+        request.type = type;
+        return push(m_buffers, std::move(request));
+    }
+
+    /**
+     * Request an immutable buffer with the specified data. This may be called from any thread.
+     *
+     * @param[in] data The data to send to the GPU, which is moved into the request.
+     * @param[in] storage The usage flags of the storage.
+     */
+    template <typename T>
+    std::shared_future<std::shared_ptr<gl::Buffer>> buffer(std::vector<T> data, gl::Buffer::Storage storage) {
+        BufferRequest request = make_request(std::move(data));
+        request.immutable = true;
+        request.storage = storage;
+        return push(m_buffers, std::move(request));
+    }
+
+    /**
+     * Request a texture with the specified pixels. This may be called from any thread.
+     *
+     * @param[in] width The width of the texture.
+     * @param[in] height The height of the texture.
+     * @param[in] components The number of components per pixel.
+     * @param[in] dtype The data type of the texture format.
+     * @param[in] pixels The pixels to load into the texture, which are moved into the request.
+     * @param[in] alignment The byte alignment 1, 2, 4 or 8.
+     */
+    template <typename T>
+    std::shared_future<std::shared_ptr<gl::Texture>> texture(int width,
+                                                             int height,
+                                                             int components,
+                                                             const gl::PixelType& dtype,
+                                                             std::vector<T> pixels,
+                                                             int alignment = 1) {
+        auto owner = std::make_shared<std::vector<T>>(std::move(pixels));
+
+        TextureRequest request{owner, owner->empty() ? nullptr : owner->data(), width, height, components, &dtype,
+                               alignment, {}};
+        return push(m_textures, std::move(request));
+    }
+
+    /**
+     * Request a program built from the specified shader sources. This may be
+     * called from any thread.
+     *
+     * @param[in] stages The stages and the source code of their shaders.
+     */
+    std::shared_future<std::shared_ptr<gl::Program>> program(std::vector<std::pair<unsigned, std::string>> stages);
+
+    /**
+     * The number of requests waiting to be materialized.
+     */
+    size_t pending() const noexcept;
+
+    /**
+     * Create the objects of all pending requests. This must be called from
+     * the thread that owns the GL context.
+     *
+     * @return The number of requests that were materialized.
+     */
+    size_t materialize();
+
+private:
+    struct BufferRequest {
+        std::shared_ptr<const void> owner;
+        const void* data;
+        size_t size;
+        bool immutable;
+        gl::Buffer::Type type;
+        gl::Buffer::Storage storage;
+        std::promise<std::shared_ptr<gl::Buffer>> promise;
+    };
+
+    struct TextureRequest {
+        std::shared_ptr<const void> owner;
+        const void* data;
+        int width;
+        int height;
+        int components;
+        const gl::PixelType* dtype;
+        int alignment;
+        std::promise<std::shared_ptr<gl::Texture>> promise;
+    };
+
+    struct ProgramRequest {
+        std::vector<std::pair<unsigned, std::string>> stages;
+        std::promise<std::shared_ptr<gl::Program>> promise;
+    };
+
+    template <typename T>
+    static BufferRequest make_request(std::vector<T> data) {
+        auto owner = std::make_shared<std::vector<T>>(std::move(data));
+        return {owner, owner->data(), sizeof(T) * owner->size(), false, gl::Buffer::Type::STATIC,
+                gl::Buffer::Storage::NONE, {}};
+    }
+
+    template <typename Request>
+    static auto push(gl::MpscQueue<Request>& queue, Request request) {
+        auto future = request.promise.get_future().share();
+        queue.push(std::move(request));
+        return future;
+    }
+
+    gl::MpscQueue<BufferRequest> m_buffers;
+    gl::MpscQueue<TextureRequest> m_textures;
+    gl::MpscQueue<ProgramRequest> m_programs;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_RESOURCE_LOADER_H */
@@ -0,0 +1,130 @@
+#ifndef GLIMPSE_RESOURCE_POOL_H
+#define GLIMPSE_RESOURCE_POOL_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/texture.hpp>
+
+#include <memory>
+
+namespace gl {
+/**
+ * A {@link ResourcePool} recycles transient buffers and textures, so that
+ * passes which allocate the same resources every frame do not create and
+ * delete OpenGL objects in steady state.
+ *
+ * Buffers are pooled by power-of-two size class and storage flags, textures
+ * by size, components, data type, samples and depth format. Resources handed
+ * out by the pool return to it when their last reference is dropped, and are
+ * handed out again on the next matching request. Idle resources beyond the
+ * capacity of the pool are deleted in least recently used order.
+ *
+ * Resources may outlive the pool, in which case they are deleted normally.
+ */
+class ResourcePool {
+public:
+    /**
+     * Statistics about the resources managed by the pool.
+     */
+    struct Statistics {
+        /**
+         * The number of requests served by an idle resource.
+         */
+        size_t hits;
+
+        /**
+         * The number of requests that created a new resource.
+         */
+        size_t misses;
+
+        /**
+         * The number of idle resources.
+         */
+        size_t idle;
+
+        /**
+         * The size in bytes of the idle resources.
+         */
+        size_t bytes;
+    };
+
+    /**
+     * Construct a resource pool.
+     *
+     * @param[in] capacity The maximum size in bytes of the idle resources to keep.
+     */
+    explicit ResourcePool(size_t capacity = 256 * 1024 * 1024);
+
+    // Disable copy constructors
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    // Enable move constructors
+    ResourcePool(ResourcePool&&) noexcept = default;
+    ResourcePool& operator=(ResourcePool&&) noexcept = default;
+
+    /**
+     * Obtain a buffer of at least the specified size. The contents of the
+     * buffer are undefined.
+     *
+     * @param[in] size The minimum size of the buffer in bytes.
+     * @param[in] storage The usage flags of the immutable storage.
+     */
+    std::shared_ptr<gl::Buffer> buffer(size_t size,
+                                       gl::Buffer::Storage storage = gl::Buffer::Storage::DYNAMIC_STORAGE);
+
+    /**
+     * Obtain a texture with the specified format. The contents of the texture
+     * are undefined.
+     *
+     * @param[in] width The width of the texture.
+     * @param[in] height The height of the texture.
+     * @param[in] components The number of components per pixel.
+     * @param[in] dtype The data type of the texture format.
+     * @param[in] samples The number of samples. Value 0 means no multisample format.
+     */
+    std::shared_ptr<gl::Texture> texture(int width,
+                                         int height,
+                                         int components,
+                                         const gl::PixelType& dtype,
+                                         int samples = 0);
+
+    /**
+     * Obtain a depth texture with the specified size. The contents of the
+     * texture are undefined.
+     *
+     * @param[in] width The width of the texture.
+     * @param[in] height The height of the texture.
+     * @param[in] samples The number of samples. Value 0 means no multisample format.
+     */
+    std::shared_ptr<gl::Texture> depth(int width, int height, int samples = 0);
+
+    /**
+     * The maximum size in bytes of the idle resources to keep.
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * Delete least recently used idle resources until their size does not
+     * exceed the specified number of bytes.
+     *
+     * @param[in] bytes The size in bytes of the idle resources to keep.
+     */
+    void trim(size_t bytes = 0);
+
+    /**
+     * Obtain statistics about the resources managed by the pool.
+     */
+    Statistics statistics() const;
+
+private:
+    struct State;
+
+    template <typename T>
+    struct Recycler;
+
+    std::shared_ptr<State> m_state;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_RESOURCE_POOL_H */
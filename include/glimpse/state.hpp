@@ -0,0 +1,182 @@
+#ifndef GLIMPSE_STATE_H
+#define GLIMPSE_STATE_H
+
+#include <glimpse/gl.hpp>
+
+#include <array>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+namespace gl {
+/**
+ * A {@link State} shadows the OpenGL state of a context, so that the library
+ * only issues a state change when the state really changes.
+ *
+ * Since a context is current on a single thread, there is one state per
+ * thread, obtained with {@link #current()}. All objects of this library change
+ * bindings and fixed-function state through it. Code that changes state
+ * behind the back of the library must call {@link #invalidate()} afterwards.
+ */
+class State {
+public:
+    /**
+     * Statistics about the state changes requested through the cache.
+     */
+    struct Statistics {
+        /**
+         * The number of state changes that were issued to OpenGL.
+         */
+        size_t issued;
+
+        /**
+         * The number of redundant state changes that were elided.
+         */
+        size_t elided;
+    };
+
+    /**
+     * The state of the context that is current on the calling thread.
+     */
+    static State& current() noexcept;
+
+    // Disable copy constructors
+    State(const State&) = delete;
+    State& operator=(const State&) = delete;
+
+    /**
+     * Forget all shadowed state, e.g. after other code changed the state of
+     * the context or the context was recreated.
+     */
+    void invalidate() noexcept;
+
+    /**
+     * Forget any binding of the specified object, because it was deleted and
+     * its name may be reused.
+     *
+     * @param[in] handle The handle of the deleted object.
+     */
+    void forget(gl::Handle handle) noexcept;
+
+    /**
+     * Obtain statistics about the state changes since the last reset.
+     */
+    Statistics statistics() const noexcept;
+
+    /**
+     * Reset the statistics, e.g. at the start of a frame.
+     */
+    void reset_statistics() noexcept;
+
+    /**
+     * Install the program for rendering.
+     */
+    void use_program(gl::Handle program) noexcept;
+
+    /**
+     * Bind the vertex array.
+     */
+    void bind_vertex_array(gl::Handle vertex_array) noexcept;
+
+    /**
+     * Bind the framebuffer for drawing and reading, or 0 for the default framebuffer.
+     */
+    void bind_framebuffer(gl::Handle framebuffer) noexcept;
+
+    /**
+     * Bind a buffer to a non-indexed target, e.g. <code>GL_DRAW_INDIRECT_BUFFER</code>.
+     */
+    void bind_buffer(unsigned target, gl::Handle buffer) noexcept;
+
+    /**
+     * Bind a range of a buffer to an indexed target, e.g. <code>GL_UNIFORM_BUFFER</code>.
+     * A size of 0 binds the whole buffer.
+     */
+    void bind_buffer_range(unsigned target, unsigned index, gl::Handle buffer, size_t offset, size_t size) noexcept;
+
+    /**
+     * Rebind every binding of a buffer object to another buffer object, e.g.
+     * when a round-robin buffer rotates to its next backing buffer.
+     *
+     * @param[in] previous The handle of the buffer object that was bound.
+     * @param[in] buffer The handle of the buffer object to bind instead.
+     */
+    void replace_buffer(gl::Handle previous, gl::Handle buffer) noexcept;
+
+    /**
+     * Bind a texture to a texture unit.
+     */
+    void bind_texture(unsigned unit, gl::Handle texture) noexcept;
+
+    /**
+     * Bind the transform feedback object, or 0 for the default object.
+     */
+    void bind_transform_feedback(gl::Handle transform_feedback) noexcept;
+
+    /**
+     * Enable or disable a capability, e.g. <code>GL_SCISSOR_TEST</code>.
+     */
+    void set_enabled(unsigned capability, bool enabled) noexcept;
+
+    /**
+     * Set the viewport.
+     */
+    void set_viewport(int x, int y, int width, int height) noexcept;
+
+    /**
+     * Set the scissor box.
+     */
+    void set_scissor(int x, int y, int width, int height) noexcept;
+
+    /**
+     * Set the color write mask of a draw buffer.
+     */
+    void set_color_mask(unsigned index, bool red, bool green, bool blue, bool alpha) noexcept;
+
+    /**
+     * Set the depth write mask.
+     */
+    void set_depth_mask(bool enabled) noexcept;
+
+private:
+    State() = default;
+
+    /**
+     * Update the shadowed value and determine whether the change must be issued.
+     */
+    template <typename T>
+    bool change(std::optional<T>& shadow, const T& value) noexcept {
+        if (shadow == value) {
+            m_statistics.elided++;
+            return false;
+        }
+
+        shadow = value;
+        m_statistics.issued++;
+        return true;
+    }
+
+    using Rectangle = std::array<int, 4>;
+    using Range = std::tuple<gl::Handle, size_t, size_t>;
+
+    static constexpr size_t MAX_DRAW_BUFFERS = 8;
+    static constexpr size_t MAX_TEXTURE_UNITS = 32;
+
+    std::optional<gl::Handle> m_program;
+    std::optional<gl::Handle> m_vertex_array;
+    std::optional<gl::Handle> m_framebuffer;
+    std::optional<gl::Handle> m_transform_feedback;
+    std::unordered_map<unsigned, std::optional<gl::Handle>> m_buffers;
+    std::map<std::pair<unsigned, unsigned>, std::optional<Range>> m_ranges;
+    std::array<std::optional<gl::Handle>, MAX_TEXTURE_UNITS> m_textures;
+    std::unordered_map<unsigned, std::optional<bool>> m_capabilities;
+    std::optional<Rectangle> m_viewport;
+    std::optional<Rectangle> m_scissor;
+    std::array<std::optional<std::array<bool, 4>>, MAX_DRAW_BUFFERS> m_color_masks;
+    std::optional<bool> m_depth_mask;
+    Statistics m_statistics{};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_STATE_H */
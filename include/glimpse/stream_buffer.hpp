@@ -0,0 +1,152 @@
+#ifndef GLIMPSE_STREAM_BUFFER_H
+#define GLIMPSE_STREAM_BUFFER_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+#include <glimpse/fence.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link StreamBuffer} is a ring allocator for data that is rebuilt every
+ * frame, such as dynamic geometry or per-frame uniforms.
+ *
+ * The buffer is allocated once as immutable storage and stays persistently
+ * and coherently mapped, so the CPU writes directly into GPU visible memory.
+ * The storage is split into a number of frame regions, each of which is
+ * guarded by a {@link Fence}. The CPU only waits when it is about to overwrite a region
+ * the GPU has not finished reading yet.
+ *
+ * The {@link Data} slices returned by the allocator share ownership of the
+ * underlying buffer and may be bound directly to a {@link VertexArray}.
+ * Their contents remain valid until the region is reused, i.e. for
+ * <code>regions - 1</code> calls to {@link #next_frame()}.
+ */
+class StreamBuffer {
+public:
+    /**
+     * An allocation within the current frame region.
+     */
+    struct Allocation {
+        /**
+         * The view on the allocated range.
+         */
+        gl::Data data;
+
+        /**
+         * The CPU pointer to the allocated range.
+         */
+        void* memory;
+    };
+
+    /**
+     * Allocate a stream buffer.
+     *
+     * @param[in] region_size The capacity of a single frame region in bytes.
+     * @param[in] regions The number of frame regions, i.e. the number of frames the CPU may run ahead.
+     */
+    explicit StreamBuffer(size_t region_size, size_t regions = 3);
+
+    ~StreamBuffer() noexcept = default;
+
+    // Disable copy constructors
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Enable move constructors
+    StreamBuffer(StreamBuffer&&) noexcept;
+    StreamBuffer& operator=(StreamBuffer&&) noexcept;
+
+    /**
+     * Determine whether the stream buffer is still valid.
+     */
+    explicit operator bool() const noexcept;
+
+    /**
+     * The total size of the buffer in bytes.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * The capacity of a single frame region in bytes.
+     */
+    size_t region_size() const noexcept;
+
+    /**
+     * The number of frame regions.
+     */
+    size_t regions() const noexcept;
+
+    /**
+     * The number of bytes still available in the current frame region.
+     */
+    size_t available() const noexcept;
+
+    /**
+     * The underlying buffer.
+     */
+    const std::shared_ptr<gl::Buffer>& buffer() const noexcept;
+
+    /**
+     * Allocate a range from the current frame region.
+     *
+     * @param[in] size The size of the range in bytes.
+     * @param[in] stride The size of the elements in the range.
+     * @param[in] descriptor The descriptor describing the contents of the range.
+     * @param[in] alignment The alignment of the start of the range in bytes (a power of two).
+     */
+    Allocation allocate(size_t size, size_t stride, gl::ElementDescriptor descriptor, size_t alignment);
+
+    /**
+     * Allocate a range for <code>count</code> items of type <code>T</code> from the current frame region.
+     *
+     * @param[in] count The number of items to allocate.
+     * @param[in] alignment The alignment of the start of the range in bytes (a power of two).
+     */
+    template <typename T>
+    Allocation allocate(size_t count, size_t alignment = alignof(T)) {
+        return allocate(sizeof(T) * count, sizeof(T), gl::ElementDescriptor::get<T>(), alignment);
+    }
+
+    /**
+     * Copy the specified data into the current frame region.
+     *
+     * @param[in] data The contiguous range of data to write.
+     * @param[in] alignment The alignment of the start of the range in bytes (a power of two).
+     */
+    template <typename R, typename T = gl::range_value_t<R>, typename = gl::enable_if_range_t<R>>
+    gl::TypedData<T> write(const R& data, size_t alignment = alignof(T)) {
+        Allocation allocation = allocate<T>(std::size(data), alignment);
+        std::memcpy(allocation.memory, std::data(data), gl::size_bytes(data));
+        return gl::TypedData<T>(m_buffer, allocation.data.slice(), allocation.data.descriptor());
+    }
+
+    /**
+     * Finish the current frame region and advance to the next one.
+     *
+     * This inserts a fence after the commands that consume the current region
+     * and waits for the GPU to release the next region if necessary.
+     */
+    void next_frame();
+
+private:
+    /**
+     * Swap object state.
+     */
+    void swap(StreamBuffer& other) noexcept;
+
+    std::shared_ptr<gl::Buffer> m_buffer;
+    gl::MappedRange<unsigned char> m_mapping;
+    size_t m_region_size{};
+    size_t m_regions{};
+    size_t m_region{};
+    size_t m_offset{};
+    std::vector<gl::Fence> m_fences;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_STREAM_BUFFER_H */
@@ -37,20 +37,20 @@ public:
      * @param[in] height The height of the texture.
      * @param[in] components The number of components per pixel.
      * @param[in] dtype The data type of the texture format.
-     * @param[in] data The data to load into the texture.
+     * @param[in] data The contiguous range of data to load into the texture.
      * @param[in] samples The number of samples. Value 0 means no multisample
      * format.
      * @param[in] alignment The byte alignment 1, 2, 4 or 8.
      */
-    template <typename T>
+    template <typename R, typename = gl::enable_if_range_t<R>>
     Texture(int width,
             int height,
             int components,
             const gl::PixelType& dtype,
-            const typename std::vector<T>& data,
+            const R& data,
             int samples = 0,
             int alignment = 1)
-        : Texture(width, height, components, false, dtype, data.data(), samples, alignment) {}
+        : Texture(width, height, components, false, dtype, std::data(data), samples, alignment) {}
 
     /**
      * Create an OpenGL texture and load data into it.
@@ -72,7 +72,7 @@ public:
             const void* data,
             int samples = 0,
             int alignment = 1)
-        : Texture(width, height, components, false, dtype, data, samples) {}
+        : Texture(width, height, components, false, dtype, data, samples, alignment) {}
 
     /**
      * Construct a depth {@link Texture}.
@@ -145,13 +145,13 @@ public:
     /**
      * Update the content of the texture.
      *
-     * @param[in] data The data to write to the texture.
+     * @param[in] data The contiguous range of data to write to the texture.
      * @param[in] level The mipmap level.
      * @param[in] alignment The alignment of the pixels.
      */
-    template <typename T>
-    void write(const typename std::vector<T>& data, int level = 0, int alignment = 1) {
-        write(data.data(), sizeof(T) * data.size(), level, alignment);
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    void write(const R& data, int level = 0, int alignment = 1) {
+        write(std::data(data), gl::size_bytes(data), level, alignment);
     }
 
     /**
@@ -174,6 +174,8 @@ public:
     void use(unsigned location);
 
 private:
+    friend class ResourceLoader;
+
     /**
      * Create an OpenGL texture and load data into it.
      *
@@ -187,6 +189,8 @@ private:
      * @param[in] samples The number of samples. Value 0 means no multisample
      * format.
      * @param[in] alignment The byte alignment 1, 2, 4 or 8.
+     * @param[in] handle The texture object to take ownership of, or
+     * <code>INVALID</code> to create a new one.
      */
     Texture(int width,
             int height,
@@ -195,7 +199,8 @@ private:
             const gl::PixelType& dtype,
             const void* data,
             int samples = 0,
-            int alignment = 1);
+            int alignment = 1,
+            gl::Handle handle = INVALID);
 
     /**
      * Reset the object state.
@@ -375,6 +380,11 @@ public:
      */
     int components() const noexcept { return m_components; }
 
+    /**
+     * The data type of the texture.
+     */
+    const gl::PixelType& dtype() const noexcept { return m_dtype; }
+
     /**
      * The handle to the native OpenGL object.
      */
@@ -0,0 +1,115 @@
+#ifndef GLIMPSE_TRANSFORM_FEEDBACK_H
+#define GLIMPSE_TRANSFORM_FEEDBACK_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/data.hpp>
+
+#include <vector>
+
+namespace gl {
+/**
+ * A {@link TransformFeedback} object captures the varyings written by the
+ * vertex processing stages into {@link Data} views, e.g. to skin or deform a
+ * mesh once and draw the result many times.
+ *
+ * The varyings to capture are declared with {@link ProgramBuilder#capture}
+ * before the program is linked. Captures are recorded with
+ * {@link VertexArray#render} and the captured vertices can be drawn again
+ * with {@link VertexArray#render_feedback} without reading the vertex count
+ * back to the CPU.
+ *
+ * Transform feedback objects have unique ownership and may not be copied
+ * (only moved).
+ */
+class TransformFeedback {
+public:
+    /**
+     * Construct a transform feedback object that captures into the specified
+     * views. With interleaved capture a single view receives all varyings,
+     * with separate capture view <code>i</code> receives varying <code>i</code>.
+     *
+     * @param[in] targets The views to capture into.
+     */
+    explicit TransformFeedback(std::vector<gl::Data> targets);
+
+    ~TransformFeedback() noexcept;
+
+    // Disable copy constructors
+    TransformFeedback(const TransformFeedback&) = delete;
+    TransformFeedback& operator=(const TransformFeedback&) = delete;
+
+    // Enable move constructors
+    TransformFeedback(TransformFeedback&&) noexcept;
+    TransformFeedback& operator=(TransformFeedback&&) noexcept;
+
+    TransformFeedback& operator=(std::nullptr_t);
+
+    /**
+     * Determine whether the transform feedback object is still valid.
+     */
+    explicit operator bool() const noexcept;
+
+    /**
+     * The views the varyings are captured into.
+     */
+    const std::vector<gl::Data>& targets() const noexcept;
+
+    /**
+     * The handle to the native OpenGL object.
+     */
+    gl::Handle native_handle() const noexcept;
+
+    /**
+     * Start capturing the primitives of subsequent draws.
+     *
+     * @param[in] primitive The type of the captured primitives, i.e.
+     * <code>GL_POINTS</code>, <code>GL_LINES</code> or <code>GL_TRIANGLES</code>.
+     * This is the output of the last vertex processing stage, so with a
+     * geometry or tessellation stage it differs from the rendering mode.
+     */
+    void begin(unsigned primitive) noexcept;
+
+    /**
+     * Stop capturing primitives.
+     */
+    void end() noexcept;
+
+    /**
+     * Determine whether the number of primitives written by the last capture
+     * is available without stalling.
+     */
+    bool available() const noexcept;
+
+    /**
+     * The number of primitives written by the last capture. This waits for
+     * the capture to complete.
+     */
+    size_t primitives() const noexcept;
+
+private:
+    /**
+     * Rebind the targets whose native handle changed since they were last
+     * bound, e.g. because they rotate between backing buffers.
+     */
+    void rebind() noexcept;
+
+    /**
+     * Reset the object state.
+     */
+    void reset() noexcept;
+
+    /**
+     * Swap object state.
+     */
+    void swap(TransformFeedback& other) noexcept;
+
+    static constexpr gl::Handle INVALID = 0xFFFFFFFF;
+
+    gl::Handle m_handle{INVALID};
+    gl::Handle m_query{INVALID};
+    std::vector<gl::Data> m_targets;
+    std::vector<gl::Handle> m_handles;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_TRANSFORM_FEEDBACK_H */
@@ -6,10 +6,85 @@
 
 #include <glm/glm.hpp>
 
-#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace gl {
+class Uniform;
+
+/**
+ * A {@link UniformShadow} keeps a CPU-side copy of the values of the uniforms
+ * of a program, so that writing the value a uniform already holds does not
+ * reach OpenGL.
+ *
+ * Each uniform owns a slot sized from its reflected type and array size. A
+ * slot only remembers the values that were written through the library, so
+ * the first write of a value is always issued.
+ */
+class UniformShadow {
+public:
+    /**
+     * Statistics about the writes to the uniforms.
+     */
+    struct Statistics {
+        /**
+         * The number of writes that were skipped, because the value was unchanged.
+         */
+        size_t hits;
+
+        /**
+         * The number of writes that were issued to OpenGL.
+         */
+        size_t misses;
+    };
+
+    /**
+     * Allocate slots for the specified uniforms and attach the uniforms to them.
+     */
+    explicit UniformShadow(std::unordered_map<std::string, gl::Uniform>& uniforms);
+
+    // Disable copy constructors, the uniforms refer to the shadow
+    UniformShadow(const UniformShadow&) = delete;
+    UniformShadow& operator=(const UniformShadow&) = delete;
+
+    /**
+     * Record a write to a slot and determine whether it changes the value.
+     *
+     * @param[in] slot The slot of the uniform.
+     * @param[in] offset The offset of the slot in the storage.
+     * @param[in] capacity The size of the slot.
+     * @param[in] start The offset of the value in the slot, e.g. of an array element.
+     * @param[in] value The value to write.
+     * @param[in] size The size of the value in bytes.
+     * @return <code>true</code> if the value must be written to OpenGL.
+     */
+    bool write(unsigned slot, size_t offset, size_t capacity, size_t start, const void* value, size_t size) noexcept;
+
+    /**
+     * Forget all values, e.g. after the uniforms were written behind the back
+     * of the library.
+     */
+    void invalidate() noexcept;
+
+    /**
+     * Obtain statistics about the writes to the uniforms.
+     */
+    Statistics statistics() const noexcept;
+
+private:
+    std::vector<unsigned char> m_values;
+    std::vector<size_t> m_known;
+    Statistics m_statistics{};
+};
+
 /**
  * A uniform is a global GLSL variable declared with the "uniform" storage
  * qualifier. These act as parameters that the user of a shader program can pass
@@ -48,6 +123,11 @@ public:
      */
     int count() const noexcept;
 
+    /**
+     * The size in bytes of a single element of the uniform.
+     */
+    size_t size() const noexcept;
+
     /**
      * Write the specified value to uniform storage.
      */
@@ -90,10 +170,296 @@ public:
     Uniform& operator=(const glm::mat4& value);
     Uniform& operator=(const glm::dmat4& value);
 
+    /**
+     * Write consecutive elements of a uniform array with a single call.
+     * Booleans are written as integers.
+     *
+     * @param[in] values The contiguous range of values to write.
+     * @param[in] first The index of the first array element to write.
+     * @throws std::out_of_range The values exceed the array size of the uniform.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    Uniform& write(const R& values, int first = 0) {
+        return write(std::data(values), std::size(values), first);
+    }
+
+    /**
+     * Write consecutive elements of a uniform array with a single call.
+     *
+     * @param[in] values The values to write.
+     * @param[in] count The number of values to write.
+     * @param[in] first The index of the first array element to write.
+     * @throws std::out_of_range The values exceed the array size of the uniform.
+     */
+    Uniform& write(const int* values, size_t count, int first = 0);
+    Uniform& write(const unsigned* values, size_t count, int first = 0);
+    Uniform& write(const float* values, size_t count, int first = 0);
+    Uniform& write(const double* values, size_t count, int first = 0);
+    Uniform& write(const glm::ivec2* values, size_t count, int first = 0);
+    Uniform& write(const glm::uvec2* values, size_t count, int first = 0);
+    Uniform& write(const glm::vec2* values, size_t count, int first = 0);
+    Uniform& write(const glm::dvec2* values, size_t count, int first = 0);
+    Uniform& write(const glm::ivec3* values, size_t count, int first = 0);
+    Uniform& write(const glm::uvec3* values, size_t count, int first = 0);
+    Uniform& write(const glm::vec3* values, size_t count, int first = 0);
+    Uniform& write(const glm::dvec3* values, size_t count, int first = 0);
+    Uniform& write(const glm::ivec4* values, size_t count, int first = 0);
+    Uniform& write(const glm::uvec4* values, size_t count, int first = 0);
+    Uniform& write(const glm::vec4* values, size_t count, int first = 0);
+    Uniform& write(const glm::dvec4* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat2* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat2* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat2x3* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat2x3* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat2x4* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat2x4* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat3x2* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat3x2* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat3* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat3* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat3x4* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat3x4* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat4x2* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat4x2* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat4x3* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat4x3* values, size_t count, int first = 0);
+    Uniform& write(const glm::mat4* values, size_t count, int first = 0);
+    Uniform& write(const glm::dmat4* values, size_t count, int first = 0);
+
 private:
+    friend class UniformShadow;
+
+    /**
+     * Determine whether writing the value changes the uniform, and record it
+     * in the shadow if so.
+     */
+    template <typename T>
+    bool changed(const T& value) noexcept {
+        return !m_shadow || m_shadow->write(m_slot, m_offset, m_capacity, 0, &value, sizeof(T));
+    }
+
+    /**
+     * Check that the array elements exist, and determine whether writing
+     * them changes the uniform.
+     */
+    bool changed(const void* values, size_t size, size_t count, int first);
+
+    /**
+     * The location of an array element, which is queried once and cached.
+     */
+    int element_location(int first);
+
     gl::Type m_type{0xFFFFFF};
     int m_location{-1};
     int m_count{0};
+    std::vector<int> m_locations;
+    gl::UniformShadow* m_shadow{nullptr};
+    unsigned m_slot{0};
+    size_t m_offset{0};
+    size_t m_capacity{0};
+};
+
+/**
+ * A {@link UniformHandle} refers to a uniform of a program resolved once with
+ * {@link Program#uniform()}, so that writes neither hash nor allocate. A
+ * handle to a uniform that does not exist ignores writes, like an invalid
+ * {@link Uniform}.
+ *
+ * The handle is valid as long as the program is.
+ */
+class UniformHandle {
+public:
+    /**
+     * Create a handle to no uniform.
+     */
+    UniformHandle() noexcept = default;
+
+    /**
+     * Create a handle to the specified uniform.
+     */
+    explicit UniformHandle(gl::Uniform* uniform) noexcept;
+
+    /**
+     * Determine whether the handle refers to an active uniform.
+     */
+    explicit operator bool() const noexcept;
+
+    /**
+     * The location of the uniform, or -1 if the handle refers to no uniform.
+     */
+    int location() const noexcept;
+
+    /**
+     * The uniform the handle refers to.
+     */
+    gl::Uniform& operator*() const noexcept { return *m_uniform; }
+    gl::Uniform* operator->() const noexcept { return m_uniform; }
+
+    /**
+     * Write the specified value to uniform storage, see {@link Uniform}.
+     */
+    template <typename T>
+    UniformHandle& operator=(const T& value) {
+        if (m_uniform) {
+            *m_uniform = value;
+        }
+        return *this;
+    }
+
+private:
+    gl::Uniform* m_uniform{nullptr};
+};
+
+/**
+ * A {@link UniformBatch} records writes of mixed types to the uniforms of one
+ * or more programs and applies them in a single pass, e.g. the material
+ * constants of a draw. The values are copied into the batch, so a batch can
+ * be built once and applied every frame.
+ *
+ * The uniforms must stay alive while the batch refers to them.
+ */
+class UniformBatch {
+public:
+    /**
+     * Record a write of a single value. Booleans are written as integers.
+     *
+     * @param[in] uniform The uniform to write.
+     * @param[in] value The value to write.
+     */
+    template <typename T>
+    UniformBatch& set(gl::Uniform& uniform, const T& value) {
+        if constexpr (std::is_same<T, bool>::value) {
+            int integer = value;
+            return record(uniform, &integer, 1, 0);
+        } else {
+            return record(uniform, &value, 1, 0);
+        }
+    }
+
+    /**
+     * Record a write of consecutive elements of a uniform array.
+     *
+     * @param[in] uniform The uniform to write.
+     * @param[in] values The contiguous range of values to write.
+     * @param[in] first The index of the first array element to write.
+     * @throws std::out_of_range The values exceed the array size of the uniform.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    UniformBatch& set_array(gl::Uniform& uniform, const R& values, int first = 0) {
+        return record(uniform, std::data(values), std::size(values), first);
+    }
+
+    /**
+     * Apply the recorded writes in order of recording.
+     */
+    void apply() const;
+
+    /**
+     * The number of recorded writes.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * Remove all recorded writes.
+     */
+    void clear() noexcept;
+
+    /**
+     * The types of values that can be written.
+     */
+    using Types = std::tuple<int,
+                             unsigned,
+                             float,
+                             double,
+                             glm::ivec2,
+                             glm::uvec2,
+                             glm::vec2,
+                             glm::dvec2,
+                             glm::ivec3,
+                             glm::uvec3,
+                             glm::vec3,
+                             glm::dvec3,
+                             glm::ivec4,
+                             glm::uvec4,
+                             glm::vec4,
+                             glm::dvec4,
+                             glm::mat2,
+                             glm::dmat2,
+                             glm::mat2x3,
+                             glm::dmat2x3,
+                             glm::mat2x4,
+                             glm::dmat2x4,
+                             glm::mat3x2,
+                             glm::dmat3x2,
+                             glm::mat3,
+                             glm::dmat3,
+                             glm::mat3x4,
+                             glm::dmat3x4,
+                             glm::mat4x2,
+                             glm::dmat4x2,
+                             glm::mat4x3,
+                             glm::dmat4x3,
+                             glm::mat4,
+                             glm::dmat4>;
+
+    /**
+     * The index of type <code>T</code> in {@link Types}, which identifies the
+     * type of a value passed to {@link #write()}.
+     */
+    template <typename T, size_t I = 0>
+    static constexpr unsigned type_index() noexcept {
+        if constexpr (I == std::tuple_size<Types>::value) {
+            static_assert(I != I, "The type cannot be written to a uniform");
+            return 0;
+        } else if constexpr (std::is_same<std::tuple_element_t<I, Types>, T>::value) {
+            return I;
+        } else {
+            return type_index<T, I + 1>();
+        }
+    }
+
+    /**
+     * Write values whose type is only known at runtime, e.g. values recorded
+     * into a command stream.
+     *
+     * @param[in] uniform The uniform to write.
+     * @param[in] type The index of the type of the values, see {@link #type_index()}.
+     * @param[in] values The values, aligned for their type.
+     * @param[in] count The number of values.
+     * @param[in] first The index of the first array element to write.
+     */
+    static void write(gl::Uniform& uniform, unsigned type, const void* values, size_t count, int first);
+
+private:
+
+    template <typename T>
+    UniformBatch& record(gl::Uniform& uniform, const T* values, size_t count, int first) {
+        if (first < 0 || static_cast<size_t>(first) + count > static_cast<size_t>(std::max(uniform.count(), 1))) {
+            throw std::out_of_range("Writing past the end of the uniform array " + uniform.name());
+        }
+
+        // Keep every value aligned, so it can be read in place
+        size_t offset = (m_values.size() + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                        alignof(std::max_align_t);
+        m_values.resize(offset + sizeof(T) * count);
+        std::memcpy(m_values.data() + offset, values, sizeof(T) * count);
+        m_writes.push_back({&uniform, type_index<T>(), offset, count, first});
+        return *this;
+    }
+
+    /**
+     * A recorded write.
+     */
+    struct Write {
+        gl::Uniform* uniform;
+        unsigned type;
+        size_t offset;
+        size_t count;
+        int first;
+    };
+
+    std::vector<Write> m_writes;
+    std::vector<unsigned char> m_values;
 };
 }  // namespace gl
 #endif /* GLIMPSE_UNIFORM_H */
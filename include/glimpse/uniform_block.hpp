@@ -0,0 +1,139 @@
+#ifndef GLIMPSE_UNIFORM_BLOCK_H
+#define GLIMPSE_UNIFORM_BLOCK_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/block.hpp>
+#include <glimpse/block_layout.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <valarray>
+
+namespace gl {
+/**
+ * A {@link UniformBlock} holds one or more instances of structure
+ * <code>T</code> in a uniform buffer, so that a single upload can feed the
+ * uniform blocks of many programs and draws instead of setting uniforms one
+ * call at a time.
+ *
+ * The native layout of <code>T</code> is checked against the std140 rules at
+ * compile time, so instances are copied to the GPU as is. <code>T</code> must
+ * declare its members in <code>T::layout</code>, see {@link Members}. Each
+ * instance starts at a multiple of the uniform buffer offset alignment, so
+ * every instance can be bound on its own.
+ */
+template <typename T>
+class UniformBlock {
+    static_assert(gl::has_members<T>::value, "T must declare its members in T::layout using gl::members");
+    static_assert(gl::is_block_layout<T, gl::BlockLayout::STD140>::value,
+                  "T does not follow the std140 layout, reorder its members or insert gl::Padding");
+
+public:
+    /**
+     * Allocate a uniform buffer for the specified number of instances.
+     *
+     * @param[in] count The number of instances of <code>T</code>.
+     * @param[in] type The type of buffer to allocate.
+     */
+    explicit UniformBlock(size_t count = 1, gl::Buffer::Type type = gl::Buffer::Type::DYNAMIC)
+        : m_stride(gl::align_up(block_size(), gl::Buffer::offset_alignment(gl::Buffer::Target::UNIFORM))),
+          m_data(std::make_shared<gl::Buffer>(m_stride * count, type),
+                 std::slice(0, m_stride * count, m_stride),
+                 gl::ElementDescriptor::get<T>()) {}
+
+    /**
+     * The number of instances in the buffer.
+     */
+    size_t size() const noexcept { return m_data.size(); }
+
+    /**
+     * The distance in bytes between the starts of consecutive instances.
+     */
+    size_t stride() const noexcept { return m_stride; }
+
+    /**
+     * The view on the underlying buffer.
+     */
+    const gl::Data& data() const noexcept { return m_data; }
+
+    /**
+     * Write an instance to the buffer.
+     *
+     * @param[in] value The value to write.
+     * @param[in] index The index of the instance to write.
+     */
+    void write(const T& value, size_t index = 0) {
+        if (index >= size()) {
+            throw std::out_of_range("Writing past the end of the uniform block");
+        }
+
+        m_data.buffer().write(&value, sizeof(T), static_cast<int>(index * m_stride));
+    }
+
+    /**
+     * Write consecutive instances to the buffer with a single upload.
+     *
+     * @param[in] values The contiguous range of values to write.
+     * @param[in] first The index of the first instance to write.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    void write(const R& values, size_t first = 0) {
+        static_assert(std::is_same<gl::range_value_t<R>, T>::value, "The range must hold instances of T");
+
+        if (first + std::size(values) > size()) {
+            throw std::out_of_range("Writing past the end of the uniform block");
+        } else if (std::size(values) == 0) {
+            // Mapping an empty range is an error
+            return;
+        }
+
+        auto range = m_data.buffer().template map<unsigned char>(
+            m_stride * std::size(values), m_stride * first,
+            gl::Buffer::Access::WRITE | gl::Buffer::Access::INVALIDATE_RANGE);
+        for (size_t i = 0; i < std::size(values); i++) {
+            std::memcpy(range.data() + i * m_stride, std::data(values) + i, sizeof(T));
+        }
+    }
+
+    /**
+     * Bind an instance to a uniform buffer binding point.
+     *
+     * @param[in] binding The binding point to bind the instance to.
+     * @param[in] index The index of the instance to bind.
+     */
+    void bind(unsigned binding, size_t index = 0) const noexcept {
+        m_data.buffer().bind_range(gl::Buffer::Target::UNIFORM, binding, index * m_stride, block_size());
+    }
+
+    /**
+     * Bind an instance to a binding point and let the uniform block of a
+     * program read from it.
+     *
+     * @param[in] block The uniform block of the program.
+     * @param[in] binding The binding point to bind the instance to.
+     * @param[in] index The index of the instance to bind.
+     */
+    void bind(gl::Block& block, unsigned binding, size_t index = 0) const {
+        if (block.size() > block_size()) {
+            throw std::invalid_argument("The uniform block " + block.name() + " is larger than the structure");
+        }
+
+        block.set_binding(binding);
+        bind(binding, index);
+    }
+
+private:
+    /**
+     * The size of an instance rounded up to the alignment of a structure.
+     */
+    static constexpr size_t block_size() noexcept { return gl::block_traits<T, gl::BlockLayout::STD140>::size; }
+
+    size_t m_stride;
+    gl::Data m_data;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_UNIFORM_BLOCK_H */
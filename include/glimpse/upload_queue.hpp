@@ -0,0 +1,196 @@
+#ifndef GLIMPSE_UPLOAD_QUEUE_H
+#define GLIMPSE_UPLOAD_QUEUE_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/stream_buffer.hpp>
+#include <glimpse/texture.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace gl {
+/**
+ * An {@link UploadQueue} batches many small {@link Buffer} and {@link Texture}
+ * writes through a single staging buffer.
+ *
+ * Writes are copied into the staging buffer immediately, so the source data
+ * may be released right after the call. The GPU side copies are deferred
+ * until {@link #flush()}, which sorts them by destination, merges adjacent
+ * ranges and issues one <code>glCopyNamedBufferSubData</code> or pixel unpack
+ * buffer sourced <code>glTextureSubImage*</code> call per merged range.
+ *
+ * The destination objects must stay alive until the queue is flushed.
+ */
+class UploadQueue {
+public:
+    /**
+     * Statistics about the writes submitted by a flush.
+     */
+    struct Statistics {
+        /**
+         * The number of bytes uploaded.
+         */
+        size_t bytes;
+
+        /**
+         * The number of writes queued.
+         */
+        size_t writes;
+
+        /**
+         * The number of GL upload commands issued for the writes.
+         */
+        size_t commands;
+
+        /**
+         * The number of writes that were merged into another command.
+         */
+        size_t coalesced() const noexcept { return writes - commands; }
+    };
+
+    /**
+     * Construct an upload queue.
+     *
+     * @param[in] capacity The number of bytes that can be staged between flushes.
+     * Writes that exceed this capacity are uploaded directly.
+     */
+    explicit UploadQueue(size_t capacity = 4 * 1024 * 1024);
+
+    // Disable copy constructors
+    UploadQueue(const UploadQueue&) = delete;
+    UploadQueue& operator=(const UploadQueue&) = delete;
+
+    // Enable move constructors
+    UploadQueue(UploadQueue&&) noexcept = default;
+    UploadQueue& operator=(UploadQueue&&) noexcept = default;
+
+    /**
+     * The number of bytes that can be staged between flushes.
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * The number of writes waiting to be flushed.
+     */
+    size_t pending() const noexcept;
+
+    /**
+     * Queue a write to a buffer.
+     *
+     * @param[in] buffer The buffer to write to.
+     * @param[in] data The data to write to the buffer.
+     * @param[in] size The size of the data in bytes.
+     * @param[in] offset The offset in bytes to write the data at.
+     */
+    void write(gl::Buffer& buffer, const void* data, size_t size, size_t offset = 0);
+
+    /**
+     * Queue a write to a buffer.
+     *
+     * @param[in] buffer The buffer to write to.
+     * @param[in] data The contiguous range of data to write to the buffer.
+     * @param[in] offset The offset in bytes to write the data at.
+     */
+    template <typename R, typename = gl::enable_if_range_t<R>>
+    void write(gl::Buffer& buffer, const R& data, size_t offset = 0) {
+        write(buffer, std::data(data), gl::size_bytes(data), offset);
+    }
+
+    /**
+     * Queue a write to the whole texture.
+     *
+     * @param[in] texture The texture to write to.
+     * @param[in] data The pixels to write to the texture.
+     * @param[in] alignment The alignment of the pixel rows. The last row does
+     * not need to be padded.
+     */
+    void write(gl::Texture& texture, const void* data, int alignment = 1) {
+        write(texture, data, glm::ivec4(0, 0, texture.width(), texture.height()), alignment);
+    }
+
+    /**
+     * Queue a write to a region of the texture.
+     *
+     * @param[in] texture The texture to write to.
+     * @param[in] data The pixels to write to the texture.
+     * @param[in] region The region to overwrite as x, y, width and height.
+     * @param[in] alignment The alignment of the pixel rows. The last row does
+     * not need to be padded.
+     */
+    void write(gl::Texture& texture, const void* data, const glm::ivec4& region, int alignment = 1);
+
+    /**
+     * Queue a write to a range of slices of a 3-dimensional texture.
+     *
+     * @param[in] texture The texture to write to.
+     * @param[in] data The pixels to write to the texture.
+     * @param[in] slice The first slice to overwrite.
+     * @param[in] slices The number of slices to overwrite.
+     * @param[in] alignment The alignment of the pixel rows. The last row does
+     * not need to be padded.
+     */
+    void write(gl::Texture3D& texture, const void* data, int slice, int slices, int alignment = 1);
+
+    /**
+     * Submit the queued writes to the GPU.
+     *
+     * @return The statistics of the writes submitted since the previous flush.
+     */
+    Statistics flush();
+
+private:
+    struct BufferCopy {
+        const gl::Buffer* buffer;
+        size_t source;
+        size_t offset;
+        size_t size;
+    };
+
+    struct TextureCopy {
+        gl::Handle texture;
+        size_t source;
+        size_t size;
+        size_t padding;
+        glm::ivec3 offset;
+        glm::ivec3 extent;
+        unsigned format;
+        unsigned type;
+        int alignment;
+        bool volume;
+    };
+
+    /**
+     * Copy the data into the staging buffer, submitting the queued writes first
+     * if the staging buffer is full.
+     *
+     * @return The offset of the data in the staging buffer.
+     */
+    size_t stage(const void* data, size_t size, size_t alignment);
+
+    /**
+     * Queue a write to a texture region, or upload it directly if it does not
+     * fit in the staging buffer.
+     *
+     * @param[in] copy The destination region of the write.
+     * @param[in] data The pixels to write.
+     * @param[in] row The size in bytes of a row of pixels, without padding.
+     * @param[in] rows The number of rows, over all slices of a volume.
+     * @param[in] element The size in bytes of a pixel component.
+     */
+    void enqueue(TextureCopy copy, const void* data, size_t row, size_t rows, size_t element);
+
+    /**
+     * Issue the GPU copies for the queued writes and advance the staging buffer.
+     */
+    void submit();
+
+    gl::StreamBuffer m_staging;
+    std::vector<BufferCopy> m_buffers;
+    std::vector<TextureCopy> m_textures;
+    Statistics m_statistics{};
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_UPLOAD_QUEUE_H */
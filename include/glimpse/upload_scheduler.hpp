@@ -0,0 +1,226 @@
+#ifndef GLIMPSE_UPLOAD_SCHEDULER_H
+#define GLIMPSE_UPLOAD_SCHEDULER_H
+
+#include <glimpse/gl.hpp>
+#include <glimpse/buffer.hpp>
+#include <glimpse/data.hpp>
+#include <glimpse/texture.hpp>
+#include <glimpse/upload_queue.hpp>
+
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace gl {
+/**
+ * A handle to a resource that is uploaded by an {@link UploadScheduler}.
+ *
+ * The resource is only handed out once all of its contents have been
+ * submitted to the GPU, so partially uploaded resources cannot be drawn.
+ */
+template <typename T>
+class Upload {
+public:
+    /**
+     * Construct an empty upload handle.
+     */
+    Upload() noexcept = default;
+
+    /**
+     * Determine whether the resource has been uploaded completely.
+     */
+    bool ready() const noexcept { return m_ready && *m_ready; }
+
+    /**
+     * The uploaded resource or <code>nullptr</code> while the upload is in progress.
+     */
+    std::shared_ptr<T> get() const noexcept { return ready() ? m_resource : nullptr; }
+
+private:
+    friend class UploadScheduler;
+
+    Upload(std::shared_ptr<T> resource, std::shared_ptr<const bool> ready) noexcept
+        : m_resource(std::move(resource)), m_ready(std::move(ready)) {}
+
+    std::shared_ptr<T> m_resource;
+    std::shared_ptr<const bool> m_ready;
+};
+
+/**
+ * An {@link UploadScheduler} spreads the upload of large resources over
+ * multiple frames.
+ *
+ * The resources are allocated immediately without contents. Their data is
+ * moved into the scheduler and trickled out through an {@link UploadQueue} in
+ * chunks: buffers by bytes, textures by rows and 3-dimensional textures by
+ * slices. Each call to {@link #update()} submits at most the configured number
+ * of bytes, but always makes progress on at least one chunk.
+ */
+class UploadScheduler {
+public:
+    /**
+     * Construct an upload scheduler.
+     *
+     * @param[in] budget The number of bytes to upload per frame.
+     * @param[in] staging The capacity of the staging buffer in bytes.
+     */
+    explicit UploadScheduler(size_t budget, size_t staging = 4 * 1024 * 1024);
+
+    // Disable copy constructors
+    UploadScheduler(const UploadScheduler&) = delete;
+    UploadScheduler& operator=(const UploadScheduler&) = delete;
+
+    // Enable move constructors
+    UploadScheduler(UploadScheduler&&) noexcept = default;
+    UploadScheduler& operator=(UploadScheduler&&) noexcept = default;
+
+    /**
+     * The number of bytes uploaded per frame.
+     */
+    size_t budget() const noexcept;
+
+    /**
+     * Change the number of bytes uploaded per frame.
+     *
+     * @param[in] budget The number of bytes to upload per frame.
+     */
+    void set_budget(size_t budget);
+
+    /**
+     * The number of bytes that still need to be uploaded.
+     */
+    size_t pending() const noexcept;
+
+    /**
+     * Schedule the upload of a buffer.
+     *
+     * @param[in] data The data to send to the GPU, which is moved into the scheduler.
+     */
+    template <typename T>
+    Upload<gl::TypedData<T>> upload(std::vector<T> data) {
+        const size_t size = sizeof(T) * data.size();
+        auto buffer = std::make_shared<gl::Buffer>(size, gl::Buffer::Storage::DYNAMIC_STORAGE);
+        auto resource = std::make_shared<gl::TypedData<T>>(buffer, std::slice(0, size, sizeof(T)),
+                                                           gl::ElementDescriptor::get<T>());
+        auto owner = std::make_shared<std::vector<T>>(std::move(data));
+
+        Job job{};
+        job.buffer = buffer.get();
+        job.unit = 1;
+        return Upload<gl::TypedData<T>>(resource, schedule(job, owner, owner->data(), size, resource, size));
+    }
+
+    /**
+     * Schedule the upload of a texture.
+     *
+     * @param[in] width The width of the texture.
+     * @param[in] height The height of the texture.
+     * @param[in] components The number of components per pixel.
+     * @param[in] dtype The data type of the texture format.
+     * @param[in] pixels The pixels to load into the texture, which are moved into the scheduler.
+     * @param[in] alignment The byte alignment 1, 2, 4 or 8 of the pixel rows.
+     */
+    template <typename T>
+    Upload<gl::Texture> upload(int width,
+                               int height,
+                               int components,
+                               const gl::PixelType& dtype,
+                               std::vector<T> pixels,
+                               int alignment = 1) {
+        auto resource = std::make_shared<gl::Texture>(width, height, components, dtype, alignment);
+        auto owner = std::make_shared<std::vector<T>>(std::move(pixels));
+
+        Job job{};
+        job.texture = resource.get();
+        job.unit = pitch(width, components, dtype, alignment);
+        job.alignment = alignment;
+        return Upload<gl::Texture>(resource,
+                                   schedule(job, owner, owner->data(), sizeof(T) * owner->size(), resource,
+                                            job.unit * static_cast<size_t>(height)));
+    }
+
+    /**
+     * Schedule the upload of a 3-dimensional texture.
+     *
+     * @param[in] width The width of the texture.
+     * @param[in] height The height of the texture.
+     * @param[in] depth The depth of the texture.
+     * @param[in] components The number of components per pixel.
+     * @param[in] dtype The data type of the texture format.
+     * @param[in] pixels The pixels to load into the texture, which are moved into the scheduler.
+     * @param[in] alignment The byte alignment 1, 2, 4 or 8 of the pixel rows.
+     */
+    template <typename T>
+    Upload<gl::Texture3D> upload(int width,
+                                 int height,
+                                 int depth,
+                                 int components,
+                                 const gl::PixelType& dtype,
+                                 std::vector<T> pixels,
+                                 int alignment = 1) {
+        auto resource = std::make_shared<gl::Texture3D>(width, height, depth, components, dtype, nullptr, alignment);
+        auto owner = std::make_shared<std::vector<T>>(std::move(pixels));
+
+        Job job{};
+        job.volume = resource.get();
+        job.unit = pitch(width, components, dtype, alignment) * static_cast<size_t>(height);
+        job.alignment = alignment;
+        return Upload<gl::Texture3D>(resource,
+                                     schedule(job, owner, owner->data(), sizeof(T) * owner->size(), resource,
+                                              job.unit * static_cast<size_t>(depth)));
+    }
+
+    /**
+     * Submit the next chunks of the scheduled uploads within the budget.
+     * This should be called once per frame.
+     *
+     * @return The statistics of the writes submitted to the GPU.
+     */
+    gl::UploadQueue::Statistics update();
+
+private:
+    struct Job {
+        std::shared_ptr<const void> data;
+        std::shared_ptr<const void> resource;
+        std::shared_ptr<bool> ready;
+        const unsigned char* bytes;
+        size_t size;
+        size_t unit;
+        size_t done;
+        int alignment;
+        gl::Buffer* buffer;
+        gl::Texture* texture;
+        gl::Texture3D* volume;
+    };
+
+    /**
+     * The size in bytes of a row of pixels.
+     */
+    static size_t pitch(int width, int components, const gl::PixelType& dtype, int alignment) noexcept;
+
+    /**
+     * Queue a job for upload.
+     *
+     * @param[in] job The destination of the upload.
+     * @param[in] data The owner of the data to upload.
+     * @param[in] bytes The data to upload.
+     * @param[in] size The size of the data in bytes.
+     * @param[in] resource The owner of the destination resource.
+     * @param[in] expected The size in bytes of the destination resource.
+     * @return The flag that indicates whether the upload completed.
+     */
+    std::shared_ptr<const bool> schedule(Job job,
+                                         std::shared_ptr<const void> data,
+                                         const void* bytes,
+                                         size_t size,
+                                         std::shared_ptr<const void> resource,
+                                         size_t expected);
+
+    gl::UploadQueue m_queue;
+    size_t m_budget;
+    std::deque<Job> m_jobs;
+};
+}  // namespace gl
+
+#endif /* GLIMPSE_UPLOAD_SCHEDULER_H */
@@ -3,10 +3,13 @@
 
 #include <glimpse/gl.hpp>
 #include <glimpse/data.hpp>
+#include <glimpse/draw_indirect_buffer.hpp>
 #include <glimpse/program.hpp>
+#include <glimpse/transform_feedback.hpp>
 
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace gl {
 /**
@@ -29,7 +32,8 @@ public:
         : VertexArray(program, data, std::optional(indices)) {}
 
     /**
-     * Create a vertex array object.
+     * Create a vertex array object. Views created with
+     * {@link Data#per_instance} advance per instance instead of per vertex.
      *
      * @param[in] program The shader program to attach to this vertex array.
      * @param[in] data The data to assign to the shader attributes.
@@ -75,14 +79,117 @@ public:
     gl::Handle native_handle() const noexcept { return m_handle; }
 
     /**
-     * Render the vertex array to the framebuffer.
+     * Determine whether an index of all ones, e.g. <code>0xFFFF</code> for
+     * 16-bit indices, restarts the primitive.
+     */
+    bool primitive_restart() const noexcept;
+
+    /**
+     * Let an index of all ones, e.g. <code>0xFFFF</code> for 16-bit indices,
+     * restart the primitive, e.g. to draw multiple triangle strips at once.
+     *
+     * @param[in] enabled Whether primitive restart is enabled.
+     */
+    void set_primitive_restart(bool enabled) noexcept;
+
+    /**
+     * Render the vertex array to the framebuffer. The type of the indices is
+     * taken from the descriptor of the index buffer.
      *
      * @param[in] mode The rendering mode to use.
+     * @param[in] vertices The number of vertices to render, or -1 to render
+     * the remaining vertices from the first.
+     * @param[in] first The index of the first index or vertex to render, e.g.
+     * to render a submesh or level of detail out of a shared index buffer.
+     * @param[in] base_vertex The value added to every index before fetching
+     * the vertex. Only used with an index buffer.
+     */
+    void render(unsigned mode, int vertices = -1, int first = 0, int base_vertex = 0) const;
+
+    /**
+     * Render multiple instances of the vertex array to the framebuffer with a
+     * single call.
+     *
+     * @param[in] mode The rendering mode to use.
+     * @param[in] vertices The number of vertices to render per instance.
+     * @param[in] instances The number of instances to render.
+     * @param[in] base_instance The index of the first instance in the per-instance data.
+     */
+    void render_instanced(unsigned mode, int vertices, int instances, unsigned base_instance = 0) const;
+
+    /**
+     * Render the vertex array and capture the varyings of the program into
+     * the targets of the transform feedback object.
+     *
+     * @param[in] mode The rendering mode to use.
+     * @param[in] feedback The transform feedback object to capture into.
+     * @param[in] primitive The type of the captured primitives, see
+     * {@link TransformFeedback#begin()}.
      * @param[in] vertices The number of vertices to render.
+     * @param[in] rasterize Whether to rasterize the primitives as well,
+     * instead of only capturing them.
+     */
+    void render(unsigned mode,
+                gl::TransformFeedback& feedback,
+                unsigned primitive,
+                int vertices = -1,
+                bool rasterize = true) const;
+
+    /**
+     * Render as many vertices as were captured by the last capture into the
+     * transform feedback object, without reading the count back to the CPU.
+     * The attributes of the vertex array should source the targets of the
+     * transform feedback object.
+     *
+     * @param[in] mode The rendering mode to use.
+     * @param[in] feedback The transform feedback object that was captured into.
      */
-    void render(unsigned mode, int vertices = -1) const;
+    void render_feedback(unsigned mode, const gl::TransformFeedback& feedback) const;
+
+    /**
+     * Render the vertex array once per indexed draw command in the view, with
+     * a single call. The commands may also be written by the GPU.
+     *
+     * @param[in] mode The rendering mode to use.
+     * @param[in] commands The view on the draw commands.
+     */
+    void render_indirect(unsigned mode, const gl::TypedData<gl::DrawElementsIndirectCommand>& commands) const;
+
+    /**
+     * Render the vertex array once per non-indexed draw command in the view,
+     * with a single call. The commands may also be written by the GPU.
+     *
+     * @param[in] mode The rendering mode to use.
+     * @param[in] commands The view on the draw commands.
+     */
+    void render_indirect(unsigned mode, const gl::TypedData<gl::DrawArraysIndirectCommand>& commands) const;
 
 private:
+    /**
+     * A vertex buffer binding along with the buffer object it was last bound to.
+     */
+    struct Binding {
+        unsigned index;
+        const gl::Data* data;
+        gl::Handle handle;
+    };
+
+    /**
+     * Rebind the buffers whose native handle changed since they were last
+     * bound, e.g. because they rotate between backing buffers.
+     */
+    void rebind() const noexcept;
+
+    /**
+     * Bind the program, the vertex array and the draw state for rendering.
+     */
+    void bind() const noexcept;
+
+    /**
+     * The offset of the specified index in the index buffer.
+     */
+    const void* index_offset(int first) const noexcept;
+
     /**
      * Reset the object state.
      */
@@ -99,7 +206,11 @@ private:
     std::shared_ptr<gl::Program> m_program;
     std::optional<gl::Data> m_indices;
     std::unordered_map<std::string, gl::Data> m_data;
+    mutable std::vector<Binding> m_bindings;
+    mutable gl::Handle m_index_handle{INVALID};
+    unsigned m_index_type{};
     size_t m_num_vertices{};
+    bool m_primitive_restart{false};
 };
 }  // namespace gl
 
@@ -0,0 +1,41 @@
+#include <glimpse/allocation_counter.hpp>
+
+#include <cstdlib>
+#include <new>
+
+// The number of allocations made by each thread
+static thread_local size_t count = 0;
+
+#ifdef GLIMPSE_COUNT_ALLOCATIONS
+// The array and non-throwing forms of the operators forward to these by default. Over-aligned allocations
+// are not counted.
+void* operator new(size_t size) {
+    count++;
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+#endif
+
+gl::AllocationCounter::AllocationCounter() noexcept : m_start(count) {}
+
+size_t gl::AllocationCounter::allocations() const noexcept {
+    return count - m_start;
+}
+
+bool gl::AllocationCounter::enabled() noexcept {
+#ifdef GLIMPSE_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
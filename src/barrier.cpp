@@ -0,0 +1,32 @@
+#include <glimpse/barrier.hpp>
+
+#include <GL/glew.h>
+
+void gl::memory_barrier(gl::Barrier barrier) noexcept {
+    if (barrier == gl::Barrier::NONE) {
+        return;
+    }
+
+    auto flags = static_cast<unsigned>(barrier);
+
+    if (barrier == gl::Barrier::ALL) {
+        glMemoryBarrier(GL_ALL_BARRIER_BITS);
+        return;
+    }
+
+    GLbitfield bits = 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::VERTEX_ATTRIB_ARRAY) ? GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::ELEMENT_ARRAY) ? GL_ELEMENT_ARRAY_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::UNIFORM) ? GL_UNIFORM_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::TEXTURE_FETCH) ? GL_TEXTURE_FETCH_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::SHADER_IMAGE_ACCESS) ? GL_SHADER_IMAGE_ACCESS_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::COMMAND) ? GL_COMMAND_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::PIXEL_BUFFER) ? GL_PIXEL_BUFFER_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::TEXTURE_UPDATE) ? GL_TEXTURE_UPDATE_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::BUFFER_UPDATE) ? GL_BUFFER_UPDATE_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::FRAMEBUFFER) ? GL_FRAMEBUFFER_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::TRANSFORM_FEEDBACK) ? GL_TRANSFORM_FEEDBACK_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::ATOMIC_COUNTER) ? GL_ATOMIC_COUNTER_BARRIER_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Barrier::SHADER_STORAGE) ? GL_SHADER_STORAGE_BARRIER_BIT : 0;
+    glMemoryBarrier(bits);
+}
@@ -0,0 +1,54 @@
+#include <glimpse/block.hpp>
+
+#include <GL/glew.h>
+
+#include <stdexcept>
+
+gl::Block::Block() noexcept = default;
+
+gl::Block::Block(gl::Handle handle,
+                 const std::string& name,
+                 gl::Block::Kind kind,
+                 unsigned index,
+                 unsigned binding,
+                 size_t size) noexcept
+    : Member(handle, name), m_kind(kind), m_index(index), m_binding(binding), m_size(size) {}
+
+gl::Block::Kind gl::Block::kind() const noexcept {
+    return m_kind;
+}
+
+unsigned gl::Block::index() const noexcept {
+    return m_index;
+}
+
+unsigned gl::Block::binding() const noexcept {
+    return m_binding;
+}
+
+size_t gl::Block::size() const noexcept {
+    return m_size;
+}
+
+void gl::Block::set_binding(unsigned binding) noexcept {
+    if (!this->operator bool()) {
+        return;
+    }
+
+    if (m_kind == gl::Block::Kind::SHADER_STORAGE) {
+        glShaderStorageBlockBinding(native_handle(), m_index, binding);
+    } else {
+        glUniformBlockBinding(native_handle(), m_index, binding);
+    }
+    m_binding = binding;
+}
+
+void gl::Block::bind(const gl::Data& data) const {
+    if (data.slice().size() < m_size) {
+        throw std::invalid_argument("The data is smaller than the block " + name());
+    }
+
+    auto target = m_kind == gl::Block::Kind::SHADER_STORAGE ? gl::Buffer::Target::SHADER_STORAGE
+                                                                       : gl::Buffer::Target::UNIFORM;
+    data.bind(target, m_binding);
+}
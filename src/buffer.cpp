@@ -1,29 +1,65 @@
 #include <glimpse/buffer.hpp>
 #include <glimpse/gl.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 
+static GLenum usage(gl::Buffer::Type type) noexcept;
+static GLbitfield storage_bits(gl::Buffer::Storage storage) noexcept;
+static GLenum indexed_target(gl::Buffer::Target target) noexcept;
+
 gl::Buffer::Buffer(const void* data, size_t size, gl::Buffer::Type type)
     : m_size(size), m_type(type) {
     glCreateBuffers(1, &m_handle);
+    specify(m_handle, data);
+}
 
-    GLenum buffer_type = 0;
-    switch (type) {
-        case gl::Buffer::Type::STATIC:
-            buffer_type = GL_STATIC_DRAW;
-            break;
-        case gl::Buffer::Type::DYNAMIC:
-            buffer_type = GL_DYNAMIC_DRAW;
-            break;
-        case gl::Buffer::Type::STREAM:
-            buffer_type = GL_STREAM_DRAW;
-            break;
+gl::Buffer::Buffer(const void* data, size_t size, gl::Buffer::Storage storage)
+    : m_size(size), m_type(gl::Buffer::Type::STATIC), m_immutable(true), m_storage(storage) {
+    validate(storage);
+
+    glCreateBuffers(1, &m_handle);
+    specify(m_handle, data);
+}
+
+gl::Buffer::Buffer(gl::Handle handle, const void* data, size_t size, gl::Buffer::Type type) noexcept
+    : m_handle(handle), m_size(size), m_type(type) {
+    specify(m_handle, data);
+}
+
+gl::Buffer::Buffer(gl::Handle handle, const void* data, size_t size, gl::Buffer::Storage storage)
+    : m_size(size), m_type(gl::Buffer::Type::STATIC), m_immutable(true), m_storage(storage) {
+    validate(storage);
+
+    // Only take ownership once the storage flags are known to be valid
+    m_handle = handle;
+    specify(m_handle, data);
+}
+
+void gl::Buffer::validate(gl::Buffer::Storage storage) {
+    auto flags = static_cast<unsigned>(storage);
+
+    if ((flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_PERSISTENT)) &&
+        !(flags & (static_cast<unsigned>(gl::Buffer::Storage::MAP_READ) |
+                   static_cast<unsigned>(gl::Buffer::Storage::MAP_WRITE)))) {
+        throw std::invalid_argument("Persistent storage requires read or write mapping");
+    } else if ((flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_COHERENT)) &&
+               !(flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_PERSISTENT))) {
+        throw std::invalid_argument("Coherent storage requires persistent mapping");
     }
+}
 
-    glNamedBufferData(m_handle, size, data, buffer_type);
+void gl::Buffer::specify(gl::Handle handle, const void* data) const noexcept {
+    if (m_immutable) {
+        glNamedBufferStorage(handle, static_cast<GLsizeiptr>(m_size), data, storage_bits(m_storage));
+    } else {
+        glNamedBufferData(handle, static_cast<GLsizeiptr>(m_size), data, usage(m_type));
+    }
 }
 
 gl::Buffer::~Buffer() noexcept {
@@ -32,7 +68,14 @@ gl::Buffer::~Buffer() noexcept {
 
 void gl::Buffer::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteBuffers(1, &m_handle);
+        if (m_backings.empty()) {
+            gl::DeletionQueue::release(gl::DeletionQueue::Kind::BUFFER, m_handle);
+        } else {
+            for (gl::Handle handle : m_backings) {
+                gl::DeletionQueue::release(gl::DeletionQueue::Kind::BUFFER, handle);
+            }
+            m_backings.clear();
+        }
         m_handle = INVALID;
     }
 }
@@ -41,6 +84,11 @@ void gl::Buffer::swap(gl::Buffer& other) noexcept {
     std::swap(m_handle, other.m_handle);
     std::swap(m_size, other.m_size);
     std::swap(m_type, other.m_type);
+    std::swap(m_immutable, other.m_immutable);
+    std::swap(m_storage, other.m_storage);
+    std::swap(m_update, other.m_update);
+    std::swap(m_backings, other.m_backings);
+    std::swap(m_backing, other.m_backing);
 }
 
 gl::Buffer::Buffer(gl::Buffer&& other) noexcept : m_size(0), m_type(gl::Buffer::Type::STATIC) {
@@ -52,9 +100,137 @@ gl::Buffer& gl::Buffer::operator=(gl::Buffer&& other) noexcept {
     return *this;
 }
 
+gl::Buffer& gl::Buffer::operator=(std::nullptr_t) {
+    reset();
+    return *this;
+}
+
+gl::Buffer::operator bool() const noexcept {
+    return m_handle != INVALID;
+}
+
+size_t gl::Buffer::size() const noexcept {
+    return m_size;
+}
+
+gl::Buffer::Type gl::Buffer::type() const noexcept {
+    return m_type;
+}
+
+bool gl::Buffer::immutable() const noexcept {
+    return m_immutable;
+}
+
+gl::Buffer::Storage gl::Buffer::storage() const noexcept {
+    return m_storage;
+}
+
+gl::Handle gl::Buffer::native_handle() const noexcept {
+    return m_handle;
+}
+
+gl::Buffer::Update gl::Buffer::update() const noexcept {
+    return m_update;
+}
+
+void gl::Buffer::set_update(gl::Buffer::Update update, size_t backings) {
+    assert(this->operator bool());
+
+    const auto flags = static_cast<unsigned>(m_storage);
+    const bool dynamic = flags & static_cast<unsigned>(gl::Buffer::Storage::DYNAMIC_STORAGE);
+    const bool writable = flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_WRITE);
+
+    if (m_immutable && update == gl::Buffer::Update::UNSYNCHRONIZED && !writable) {
+        throw std::logic_error("Unsynchronized updates require the storage to be mappable for writing");
+    } else if (m_immutable && update != gl::Buffer::Update::UNSYNCHRONIZED && !dynamic) {
+        throw std::logic_error("Immutable buffers require dynamic storage to be updated");
+    } else if (update == gl::Buffer::Update::ROUND_ROBIN && backings < 2) {
+        throw std::invalid_argument("Round-robin updates require at least two backing buffers");
+    }
+
+    // Release the backing buffers of a previous round-robin strategy, but keep the current one
+    for (gl::Handle handle : m_backings) {
+        if (handle != m_handle) {
+            gl::DeletionQueue::release(gl::DeletionQueue::Kind::BUFFER, handle);
+        }
+    }
+    m_backings.clear();
+    m_backing = 0;
+
+    if (update == gl::Buffer::Update::ROUND_ROBIN) {
+        m_backings.resize(backings);
+        m_backings[0] = m_handle;
+        glCreateBuffers(static_cast<GLsizei>(backings - 1), m_backings.data() + 1);
+
+        for (size_t i = 1; i < backings; i++) {
+            specify(m_backings[i], nullptr);
+        }
+    }
+
+    m_update = update;
+}
+
 void gl::Buffer::write(const void* data, size_t size, int offset) noexcept {
     assert(this->operator bool());
-    glNamedBufferSubData(m_handle, offset, size, data);
+    assert(offset >= 0 && static_cast<size_t>(offset) + size <= m_size);
+    assert(!m_immutable || m_update == gl::Buffer::Update::UNSYNCHRONIZED ||
+           (static_cast<unsigned>(m_storage) & static_cast<unsigned>(gl::Buffer::Storage::DYNAMIC_STORAGE)));
+
+    const bool whole = offset == 0 && size == m_size;
+
+    switch (m_update) {
+        case gl::Buffer::Update::SUBDATA:
+            break;
+        case gl::Buffer::Update::ORPHAN:
+            // Detach the storage that is still in use by in-flight commands
+            if (whole && !m_immutable) {
+                specify(m_handle, nullptr);
+            } else if (whole) {
+                glInvalidateBufferData(m_handle);
+            } else {
+                glInvalidateBufferSubData(m_handle, offset, static_cast<GLsizeiptr>(size));
+            }
+            break;
+        case gl::Buffer::Update::UNSYNCHRONIZED: {
+            void* map = glMapNamedBufferRange(m_handle, offset, static_cast<GLsizeiptr>(size),
+                                              GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                                  GL_MAP_UNSYNCHRONIZED_BIT);
+            if (map) {
+                std::memcpy(map, data, size);
+                glUnmapNamedBuffer(m_handle);
+                return;
+            }
+            // Fall back to a regular update if the buffer cannot be mapped
+            break;
+        }
+        case gl::Buffer::Update::ROUND_ROBIN: {
+            gl::Handle previous = m_handle;
+            m_backing = (m_backing + 1) % m_backings.size();
+            m_handle = m_backings[m_backing];
+
+            // Carry over the contents around the written range
+            const size_t end = static_cast<size_t>(offset) + size;
+            if (offset > 0) {
+                glCopyNamedBufferSubData(previous, m_handle, 0, 0, static_cast<GLsizeiptr>(offset));
+            }
+            if (end < m_size) {
+                glCopyNamedBufferSubData(previous, m_handle, static_cast<GLintptr>(end), static_cast<GLintptr>(end),
+                                         static_cast<GLsizeiptr>(m_size - end));
+            }
+
+            gl::State::current().replace_buffer(previous, m_handle);
+            break;
+        }
+    }
+
+    glNamedBufferSubData(m_handle, offset, static_cast<GLsizeiptr>(size), data);
+}
+
+void gl::Buffer::clear(size_t size, size_t offset, unsigned char value) noexcept {
+    assert(this->operator bool());
+    assert(offset + size <= m_size);
+    glClearNamedBufferSubData(m_handle, GL_R8UI, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size),
+                              GL_RED_INTEGER, GL_UNSIGNED_BYTE, &value);
 }
 
 std::vector<unsigned char> gl::Buffer::read() const {
@@ -66,18 +242,132 @@ std::vector<unsigned char> gl::Buffer::read(size_t size, int offset) const {
 
     if (offset < 0 || offset + size > m_size) {
         throw std::invalid_argument("Size or offset out of bounds");
+    } else if (size == 0) {
+        return {};
+    }
+
+    auto* map = static_cast<unsigned char*>(map_range(static_cast<size_t>(offset), size, gl::Buffer::Access::READ));
+    std::vector<unsigned char> res(map, map + size);
+    unmap(m_handle);
+    return res;
+}
+
+void* gl::Buffer::map_range(size_t offset, size_t size, gl::Buffer::Access access) const {
+    assert(this->operator bool());
+
+    if (offset + size > m_size) {
+        throw std::invalid_argument("Size or offset out of bounds");
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_handle);
-    auto* map = static_cast<unsigned char*>(
-        glMapBufferRange(GL_ARRAY_BUFFER, 0, m_size, GL_MAP_READ_BIT));
+    auto flags = static_cast<unsigned>(access);
+    const bool read = flags & static_cast<unsigned>(gl::Buffer::Access::READ);
+    const bool write = flags & static_cast<unsigned>(gl::Buffer::Access::WRITE);
+    const bool invalidate = flags & static_cast<unsigned>(gl::Buffer::Access::INVALIDATE_RANGE);
+    const bool unsynchronized = flags & static_cast<unsigned>(gl::Buffer::Access::UNSYNCHRONIZED);
+    const bool flush_explicit = flags & static_cast<unsigned>(gl::Buffer::Access::FLUSH_EXPLICIT);
+    const bool persistent = flags & static_cast<unsigned>(gl::Buffer::Access::PERSISTENT);
+    const bool coherent = flags & static_cast<unsigned>(gl::Buffer::Access::COHERENT);
+    const auto storage = static_cast<unsigned>(m_storage);
+
+    if (!read && !write) {
+        throw std::invalid_argument("Mapping requires read or write access");
+    } else if (read && (invalidate || unsynchronized)) {
+        throw std::invalid_argument("Read mappings cannot be invalidated or unsynchronized");
+    } else if (flush_explicit && !write) {
+        throw std::invalid_argument("Explicit flushing requires write access");
+    } else if (persistent && !(storage & static_cast<unsigned>(gl::Buffer::Storage::MAP_PERSISTENT))) {
+        throw std::invalid_argument("Persistent mappings require persistent storage");
+    } else if (coherent && !(storage & static_cast<unsigned>(gl::Buffer::Storage::MAP_COHERENT))) {
+        throw std::invalid_argument("Coherent mappings require coherent storage");
+    }
+
+    GLbitfield bits = 0;
+    bits |= read ? GL_MAP_READ_BIT : 0;
+    bits |= write ? GL_MAP_WRITE_BIT : 0;
+    bits |= invalidate ? GL_MAP_INVALIDATE_RANGE_BIT : 0;
+    bits |= unsynchronized ? GL_MAP_UNSYNCHRONIZED_BIT : 0;
+    bits |= flush_explicit ? GL_MAP_FLUSH_EXPLICIT_BIT : 0;
+    bits |= persistent ? GL_MAP_PERSISTENT_BIT : 0;
+    bits |= coherent ? GL_MAP_COHERENT_BIT : 0;
+
+    void* map =
+        glMapNamedBufferRange(m_handle, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), bits);
 
     if (!map) {
         GLenum err = glGetError();
         throw gl::Error(err);
     }
 
-    std::vector<unsigned char> res(map, map + m_size);
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-    return res;
+    return map;
+}
+
+void gl::Buffer::flush_range(gl::Handle handle, size_t offset, size_t size) noexcept {
+    glFlushMappedNamedBufferRange(handle, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void gl::Buffer::unmap(gl::Handle handle) noexcept {
+    glUnmapNamedBuffer(handle);
+}
+
+void gl::Buffer::bind(gl::Buffer::Target target, unsigned index) const noexcept {
+    gl::State::current().bind_buffer_range(indexed_target(target), index, native_handle(), 0, 0);
+}
+
+void gl::Buffer::bind_range(gl::Buffer::Target target, unsigned index, size_t offset, size_t size) const noexcept {
+    gl::State::current().bind_buffer_range(indexed_target(target), index, native_handle(), offset, size);
+}
+
+size_t gl::Buffer::offset_alignment(gl::Buffer::Target target) noexcept {
+    GLint alignment = 4;
+    switch (target) {
+        case gl::Buffer::Target::UNIFORM:
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            break;
+        case gl::Buffer::Target::SHADER_STORAGE:
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            break;
+        case gl::Buffer::Target::ATOMIC_COUNTER:
+        case gl::Buffer::Target::TRANSFORM_FEEDBACK:
+            break;
+    }
+    return static_cast<size_t>(alignment);
+}
+
+static GLenum usage(gl::Buffer::Type type) noexcept {
+    switch (type) {
+        case gl::Buffer::Type::DYNAMIC:
+            return GL_DYNAMIC_DRAW;
+        case gl::Buffer::Type::STREAM:
+            return GL_STREAM_DRAW;
+        case gl::Buffer::Type::STATIC:
+        default:
+            return GL_STATIC_DRAW;
+    }
+}
+
+static GLbitfield storage_bits(gl::Buffer::Storage storage) noexcept {
+    auto flags = static_cast<unsigned>(storage);
+
+    GLbitfield bits = 0;
+    bits |= flags & static_cast<unsigned>(gl::Buffer::Storage::DYNAMIC_STORAGE) ? GL_DYNAMIC_STORAGE_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_READ) ? GL_MAP_READ_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_WRITE) ? GL_MAP_WRITE_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_PERSISTENT) ? GL_MAP_PERSISTENT_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Buffer::Storage::MAP_COHERENT) ? GL_MAP_COHERENT_BIT : 0;
+    bits |= flags & static_cast<unsigned>(gl::Buffer::Storage::CLIENT_STORAGE) ? GL_CLIENT_STORAGE_BIT : 0;
+    return bits;
+}
+
+static GLenum indexed_target(gl::Buffer::Target target) noexcept {
+    switch (target) {
+        case gl::Buffer::Target::SHADER_STORAGE:
+            return GL_SHADER_STORAGE_BUFFER;
+        case gl::Buffer::Target::ATOMIC_COUNTER:
+            return GL_ATOMIC_COUNTER_BUFFER;
+        case gl::Buffer::Target::TRANSFORM_FEEDBACK:
+            return GL_TRANSFORM_FEEDBACK_BUFFER;
+        case gl::Buffer::Target::UNIFORM:
+        default:
+            return GL_UNIFORM_BUFFER;
+    }
 }
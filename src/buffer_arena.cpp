@@ -0,0 +1,164 @@
+#include <glimpse/buffer_arena.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+gl::BufferArena::BufferArena(size_t block_size) : m_block_size(block_size) {
+    if (block_size == 0) {
+        throw std::invalid_argument("The block size cannot be zero");
+    }
+}
+
+size_t gl::BufferArena::block_size() const noexcept {
+    return m_block_size;
+}
+
+gl::Data gl::BufferArena::allocate(size_t size,
+                                   size_t stride,
+                                   gl::ElementDescriptor descriptor,
+                                   size_t alignment) {
+    auto [buffer, offset] = reserve(size, alignment);
+    return gl::Data(std::move(buffer), std::slice(offset, size, stride > 0 ? stride : 1), descriptor);
+}
+
+std::pair<std::shared_ptr<gl::Buffer>, size_t> gl::BufferArena::reserve(size_t size, size_t alignment) {
+    if (size == 0) {
+        throw std::invalid_argument("Cannot allocate an empty range");
+    } else if (alignment == 0 || (alignment & (alignment - 1))) {
+        throw std::invalid_argument("Alignment must be a power of two");
+    }
+
+    // Any free range of at least this size can hold the request regardless of its alignment
+    const size_t worst_case = size + alignment - 1;
+
+    Block* target = nullptr;
+    std::multimap<size_t, size_t>::iterator best;
+
+    for (Block& block : m_blocks) {
+        auto it = block.by_size.lower_bound(worst_case);
+        if (it != block.by_size.end() && (!target || it->first < best->first)) {
+            target = &block;
+            best = it;
+        }
+    }
+
+    if (!target) {
+        target = &grow(worst_case);
+        best = target->by_size.begin();
+    }
+
+    const size_t range_offset = best->second;
+    const size_t range_size = best->first;
+    target->by_size.erase(best);
+    target->by_offset.erase(range_offset);
+
+    const size_t offset = (range_offset + alignment - 1) & ~(alignment - 1);
+
+    // Return the padding in front of and the remainder behind the allocation
+    if (offset > range_offset) {
+        release(*target, range_offset, offset - range_offset);
+    }
+    if (range_offset + range_size > offset + size) {
+        release(*target, offset + size, range_offset + range_size - offset - size);
+    }
+
+    target->allocations.emplace(offset, size);
+    target->used += size;
+
+    return {target->buffer, offset};
+}
+
+gl::BufferArena::Block& gl::BufferArena::grow(size_t size) {
+    size = std::max(size, m_block_size);
+
+    Block block{std::make_shared<gl::Buffer>(size, gl::Buffer::Storage::DYNAMIC_STORAGE), {}, {}, {}, 0};
+    block.by_offset.emplace(0, size);
+    block.by_size.emplace(size, 0);
+
+    m_blocks.push_back(std::move(block));
+    return m_blocks.back();
+}
+
+void gl::BufferArena::release(Block& block, size_t offset, size_t size) {
+    auto next = block.by_offset.lower_bound(offset);
+
+    if (next != block.by_offset.end() && next->first < offset + size) {
+        throw std::invalid_argument("The range was already returned to the arena");
+    }
+
+    // Coalesce with the preceding free range
+    if (next != block.by_offset.begin()) {
+        auto prev = std::prev(next);
+
+        if (prev->first + prev->second > offset) {
+            throw std::invalid_argument("The range was already returned to the arena");
+        } else if (prev->first + prev->second == offset) {
+            unlink(block, prev->first, prev->second);
+            offset = prev->first;
+            size += prev->second;
+            block.by_offset.erase(prev);
+        }
+    }
+
+    // Coalesce with the succeeding free range
+    if (next != block.by_offset.end() && next->first == offset + size) {
+        unlink(block, next->first, next->second);
+        size += next->second;
+        block.by_offset.erase(next);
+    }
+
+    block.by_offset.emplace(offset, size);
+    block.by_size.emplace(size, offset);
+}
+
+void gl::BufferArena::unlink(Block& block, size_t offset, size_t size) noexcept {
+    auto [begin, end] = block.by_size.equal_range(size);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == offset) {
+            block.by_size.erase(it);
+            return;
+        }
+    }
+}
+
+void gl::BufferArena::free(const gl::Data& data) {
+    auto it = std::find_if(m_blocks.begin(), m_blocks.end(),
+                           [&](const Block& block) { return block.buffer.get() == &data.buffer(); });
+
+    if (it == m_blocks.end()) {
+        throw std::invalid_argument("The data was not allocated by this arena");
+    }
+
+    // Only accept the exact range that was allocated, not a view narrowed with select()
+    std::slice slice = data.slice();
+    auto allocation = it->allocations.find(slice.start());
+    if (allocation == it->allocations.end() || allocation->second != slice.size()) {
+        throw std::invalid_argument("The data is not an allocation of this arena");
+    }
+
+    release(*it, allocation->first, allocation->second);
+    it->used -= allocation->second;
+    it->allocations.erase(allocation);
+}
+
+void gl::BufferArena::trim() noexcept {
+    m_blocks.erase(std::remove_if(m_blocks.begin(), m_blocks.end(),
+                                  [](const Block& block) { return block.allocations.empty(); }),
+                   m_blocks.end());
+}
+
+gl::BufferArena::Statistics gl::BufferArena::statistics() const noexcept {
+    Statistics stats{m_blocks.size(), 0, 0, 0, 0};
+
+    for (const Block& block : m_blocks) {
+        stats.allocations += block.allocations.size();
+        stats.capacity += block.buffer->size();
+        stats.used += block.used;
+
+        if (!block.by_size.empty()) {
+            stats.largest_free = std::max(stats.largest_free, block.by_size.rbegin()->first);
+        }
+    }
+
+    return stats;
+}
@@ -0,0 +1,216 @@
+#include <glimpse/command_list.hpp>
+#include <glimpse/state.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace {
+/**
+ * The kinds of recorded commands.
+ */
+enum class Opcode : std::uint32_t {
+    RENDER,
+    RENDER_INSTANCED,
+    UNIFORM,
+    BIND_TEXTURE,
+    USE_FRAMEBUFFER,
+};
+
+/**
+ * The start of every command, with the size of the command including padding.
+ */
+struct Header {
+    Opcode opcode;
+    std::uint32_t size;
+};
+
+struct RenderCommand {
+    Header header;
+    const gl::VertexArray* vertex_array;
+    unsigned mode;
+    int vertices;
+    int first;
+    int base_vertex;
+};
+
+struct RenderInstancedCommand {
+    Header header;
+    const gl::VertexArray* vertex_array;
+    unsigned mode;
+    int vertices;
+    int instances;
+    unsigned base_instance;
+};
+
+// Followed by the bytes of the value, aligned like every command
+struct UniformCommand {
+    Header header;
+    gl::Uniform* uniform;
+    unsigned type;
+};
+
+struct BindTextureCommand {
+    Header header;
+    unsigned unit;
+    gl::Handle texture;
+};
+
+struct UseFramebufferCommand {
+    Header header;
+    gl::Framebuffer* framebuffer;
+};
+}  // namespace
+
+static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+static constexpr size_t align(size_t size) noexcept {
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+template <typename C>
+static C* record(void* memory, Opcode opcode, size_t size = sizeof(C)) noexcept {
+    C* command = new (memory) C{};
+    command->header = {opcode, static_cast<std::uint32_t>(align(size))};
+    return command;
+}
+
+gl::CommandList::CommandList(size_t block_size) : m_block_size(align(block_size)) {}
+
+void gl::CommandList::render(const gl::VertexArray& vertex_array,
+                             unsigned mode,
+                             int vertices,
+                             int first,
+                             int base_vertex) {
+    auto* command = record<RenderCommand>(allocate(sizeof(RenderCommand)), Opcode::RENDER);
+    command->vertex_array = &vertex_array;
+    command->mode = mode;
+    command->vertices = vertices;
+    command->first = first;
+    command->base_vertex = base_vertex;
+}
+
+void gl::CommandList::render_instanced(const gl::VertexArray& vertex_array,
+                                       unsigned mode,
+                                       int vertices,
+                                       int instances,
+                                       unsigned base_instance) {
+    auto* command =
+        record<RenderInstancedCommand>(allocate(sizeof(RenderInstancedCommand)), Opcode::RENDER_INSTANCED);
+    command->vertex_array = &vertex_array;
+    command->mode = mode;
+    command->vertices = vertices;
+    command->instances = instances;
+    command->base_instance = base_instance;
+}
+
+void gl::CommandList::bind_texture(unsigned unit, gl::Handle texture) {
+    auto* command = record<BindTextureCommand>(allocate(sizeof(BindTextureCommand)), Opcode::BIND_TEXTURE);
+    command->unit = unit;
+    command->texture = texture;
+}
+
+void gl::CommandList::use(gl::Framebuffer& framebuffer) {
+    auto* command = record<UseFramebufferCommand>(allocate(sizeof(UseFramebufferCommand)), Opcode::USE_FRAMEBUFFER);
+    command->framebuffer = &framebuffer;
+}
+
+size_t gl::CommandList::size() const noexcept {
+    return m_commands;
+}
+
+size_t gl::CommandList::bytes() const noexcept {
+    size_t bytes = 0;
+    for (size_t i = 0; i < m_blocks.size() && i <= m_current; i++) {
+        bytes += m_blocks[i].used;
+    }
+    return bytes;
+}
+
+void gl::CommandList::clear() noexcept {
+    for (Block& block : m_blocks) {
+        block.used = 0;
+    }
+    m_current = 0;
+    m_commands = 0;
+}
+
+void gl::CommandList::execute() const {
+    gl::State& state = gl::State::current();
+
+    for (size_t i = 0; i < m_blocks.size() && i <= m_current; i++) {
+        const Block& block = m_blocks[i];
+
+        for (size_t offset = 0; offset < block.used;) {
+            const unsigned char* memory = block.memory.get() + offset;
+            const auto* header = reinterpret_cast<const Header*>(memory);
+
+            switch (header->opcode) {
+                case Opcode::RENDER: {
+                    const auto* command = reinterpret_cast<const RenderCommand*>(memory);
+                    command->vertex_array->render(command->mode, command->vertices, command->first,
+                                                  command->base_vertex);
+                    break;
+                }
+                case Opcode::RENDER_INSTANCED: {
+                    const auto* command = reinterpret_cast<const RenderInstancedCommand*>(memory);
+                    command->vertex_array->render_instanced(command->mode, command->vertices, command->instances,
+                                                            command->base_instance);
+                    break;
+                }
+                case Opcode::UNIFORM: {
+                    const auto* command = reinterpret_cast<const UniformCommand*>(memory);
+                    gl::UniformBatch::write(*command->uniform, command->type, memory + align(sizeof(UniformCommand)),
+                                            1, 0);
+                    break;
+                }
+                case Opcode::BIND_TEXTURE: {
+                    const auto* command = reinterpret_cast<const BindTextureCommand*>(memory);
+                    state.bind_texture(command->unit, command->texture);
+                    break;
+                }
+                case Opcode::USE_FRAMEBUFFER: {
+                    const auto* command = reinterpret_cast<const UseFramebufferCommand*>(memory);
+                    command->framebuffer->use();
+                    break;
+                }
+            }
+
+            offset += header->size;
+        }
+    }
+}
+
+void gl::CommandList::record_uniform(gl::Uniform& uniform, unsigned type, const void* value, size_t size) {
+    // The value is read in place when replaying, so it starts at an aligned offset
+    void* memory = allocate(align(sizeof(UniformCommand)) + size);
+    auto* command = record<UniformCommand>(memory, Opcode::UNIFORM, align(sizeof(UniformCommand)) + size);
+    command->uniform = &uniform;
+    command->type = type;
+    std::memcpy(static_cast<unsigned char*>(memory) + align(sizeof(UniformCommand)), value, size);
+}
+
+void* gl::CommandList::allocate(size_t size) {
+    size = align(size);
+
+    // Advance to the next block with enough space, reusing the blocks of previous recordings
+    while (m_current < m_blocks.size() && m_blocks[m_current].used + size > m_blocks[m_current].capacity) {
+        if (m_current + 1 == m_blocks.size()) {
+            break;
+        }
+        m_current++;
+    }
+
+    if (m_blocks.empty() || m_blocks[m_current].used + size > m_blocks[m_current].capacity) {
+        size_t capacity = std::max(m_block_size, size);
+        m_blocks.push_back({std::make_unique<unsigned char[]>(capacity), capacity, 0});
+        m_current = m_blocks.size() - 1;
+    }
+
+    Block& block = m_blocks[m_current];
+    void* memory = block.memory.get() + block.used;
+    block.used += size;
+    m_commands++;
+    return memory;
+}
@@ -0,0 +1,154 @@
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <iterator>
+
+static std::atomic<gl::DeletionQueue*> installed_queue{nullptr};
+
+gl::DeletionQueue::~DeletionQueue() noexcept {
+    DeletionQueue* self = this;
+    installed_queue.compare_exchange_strong(self, nullptr);
+
+    try {
+        flush();
+    } catch (...) {
+        // A lost context cannot be waited on, delete the remaining handles regardless
+        std::vector<Entry> handles = m_queue.drain();
+        for (Batch& batch : m_batches) {
+            handles.insert(handles.end(), batch.handles.begin(), batch.handles.end());
+        }
+        destroy(handles);
+    }
+}
+
+void gl::DeletionQueue::install(gl::DeletionQueue* queue) noexcept {
+    installed_queue.store(queue);
+}
+
+gl::DeletionQueue* gl::DeletionQueue::installed() noexcept {
+    return installed_queue.load();
+}
+
+void gl::DeletionQueue::release(Kind kind, gl::Handle handle) noexcept {
+    if (DeletionQueue* queue = installed()) {
+        try {
+            queue->enqueue(kind, handle);
+            return;
+        } catch (...) {
+            // Fall back to deleting the handle immediately when out of memory
+        }
+    }
+
+    destroy(kind, &handle, 1);
+}
+
+void gl::DeletionQueue::enqueue(Kind kind, gl::Handle handle) {
+    m_queue.push({kind, handle});
+}
+
+void gl::DeletionQueue::retire() {
+    std::vector<Entry> handles = m_queue.drain();
+
+    if (!handles.empty()) {
+        m_in_flight += handles.size();
+        m_batches.push_back({gl::Fence::insert(), std::move(handles)});
+    }
+}
+
+size_t gl::DeletionQueue::collect() {
+    retire();
+
+    size_t deleted = 0;
+    while (!m_batches.empty() && m_batches.front().fence.signaled()) {
+        std::vector<Entry>& handles = m_batches.front().handles;
+        deleted += handles.size();
+        m_in_flight -= handles.size();
+        destroy(handles);
+        m_batches.pop_front();
+    }
+
+    return deleted;
+}
+
+size_t gl::DeletionQueue::flush() {
+    retire();
+
+    size_t deleted = 0;
+    while (!m_batches.empty()) {
+        m_batches.front().fence.wait();
+
+        std::vector<Entry>& handles = m_batches.front().handles;
+        deleted += handles.size();
+        m_in_flight -= handles.size();
+        destroy(handles);
+        m_batches.pop_front();
+    }
+
+    return deleted;
+}
+
+size_t gl::DeletionQueue::depth() const noexcept {
+    return m_queue.size() + m_in_flight.load();
+}
+
+size_t gl::DeletionQueue::in_flight() const noexcept {
+    return m_in_flight.load();
+}
+
+void gl::DeletionQueue::destroy(std::vector<Entry>& handles) noexcept {
+    std::sort(handles.begin(), handles.end());
+
+    std::vector<gl::Handle> names;
+    for (auto first = handles.begin(); first != handles.end();) {
+        const Kind kind = first->first;
+        auto last = std::find_if(first, handles.end(), [&](const Entry& entry) { return entry.first != kind; });
+
+        names.clear();
+        std::transform(first, last, std::back_inserter(names), [](const Entry& entry) { return entry.second; });
+        destroy(kind, names.data(), names.size());
+
+        first = last;
+    }
+}
+
+void gl::DeletionQueue::destroy(Kind kind, const gl::Handle* names, size_t count) noexcept {
+    const auto n = static_cast<GLsizei>(count);
+
+    // Deleted names may be reused by new objects, which must not be mistaken for bound ones
+    gl::State& state = gl::State::current();
+    for (size_t i = 0; i < count; i++) {
+        state.forget(names[i]);
+    }
+
+    switch (kind) {
+        case Kind::BUFFER:
+            glDeleteBuffers(n, names);
+            break;
+        case Kind::TEXTURE:
+            glDeleteTextures(n, names);
+            break;
+        case Kind::RENDERBUFFER:
+            glDeleteRenderbuffers(n, names);
+            break;
+        case Kind::FRAMEBUFFER:
+            glDeleteFramebuffers(n, names);
+            break;
+        case Kind::VERTEX_ARRAY:
+            glDeleteVertexArrays(n, names);
+            break;
+        case Kind::TRANSFORM_FEEDBACK:
+            glDeleteTransformFeedbacks(n, names);
+            break;
+        case Kind::QUERY:
+            glDeleteQueries(n, names);
+            break;
+        case Kind::PROGRAM:
+            for (size_t i = 0; i < count; i++) {
+                glDeleteProgram(names[i]);
+            }
+            break;
+    }
+}
@@ -0,0 +1,86 @@
+#include <glimpse/draw_indirect_buffer.hpp>
+#include <glimpse/vertex_array.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+gl::DrawIndirectBuffer::DrawIndirectBuffer(size_t capacity) {
+    m_elements.reserve(capacity);
+    m_arrays.reserve(capacity);
+
+    // Allocate the buffer up front, so the views never refer to a null buffer
+    size_t size = sizeof(DrawElementsIndirectCommand) * std::max<size_t>(capacity, 1);
+    m_buffer = std::make_shared<gl::Buffer>(size, gl::Buffer::Type::STREAM);
+}
+
+void gl::DrawIndirectBuffer::add(const gl::DrawElementsIndirectCommand& command) {
+    m_elements.push_back(command);
+    m_dirty = true;
+}
+
+void gl::DrawIndirectBuffer::add(const gl::DrawArraysIndirectCommand& command) {
+    m_arrays.push_back(command);
+    m_dirty = true;
+}
+
+void gl::DrawIndirectBuffer::clear() noexcept {
+    m_elements.clear();
+    m_arrays.clear();
+    m_dirty = true;
+}
+
+size_t gl::DrawIndirectBuffer::size() const noexcept {
+    return m_elements.size() + m_arrays.size();
+}
+
+void gl::DrawIndirectBuffer::upload() {
+    if (!m_dirty) {
+        return;
+    }
+
+    const size_t elements_size = gl::size_bytes(m_elements);
+    const size_t arrays_size = gl::size_bytes(m_arrays);
+    const size_t size = elements_size + arrays_size;
+
+    if (m_buffer->size() < size) {
+        // Grow geometrically, so that adding commands every frame does not reallocate every frame
+        size_t capacity = std::max(size, 2 * m_buffer->size());
+        m_buffer = std::make_shared<gl::Buffer>(capacity, gl::Buffer::Type::STREAM);
+    }
+
+    if (size != 0) {
+        // A single invalidating map replaces both command arrays without waiting for the previous draws
+        auto range = m_buffer->map<unsigned char>(
+            size, 0, gl::Buffer::Access::WRITE | gl::Buffer::Access::INVALIDATE_RANGE);
+        std::memcpy(range.data(), m_elements.data(), elements_size);
+        std::memcpy(range.data() + elements_size, m_arrays.data(), arrays_size);
+    }
+
+    m_uploaded_elements = m_elements.size();
+    m_uploaded_arrays = m_arrays.size();
+    m_dirty = false;
+}
+
+gl::TypedData<gl::DrawElementsIndirectCommand> gl::DrawIndirectBuffer::elements() const {
+    std::slice slice(0, sizeof(DrawElementsIndirectCommand) * m_uploaded_elements,
+                     sizeof(DrawElementsIndirectCommand));
+    return gl::TypedData<DrawElementsIndirectCommand>(m_buffer, slice);
+}
+
+gl::TypedData<gl::DrawArraysIndirectCommand> gl::DrawIndirectBuffer::arrays() const {
+    std::slice slice(sizeof(DrawElementsIndirectCommand) * m_uploaded_elements,
+                     sizeof(DrawArraysIndirectCommand) * m_uploaded_arrays, sizeof(DrawArraysIndirectCommand));
+    return gl::TypedData<DrawArraysIndirectCommand>(m_buffer, slice);
+}
+
+void gl::DrawIndirectBuffer::submit(const gl::VertexArray& vertex_array, unsigned mode) {
+    upload();
+
+    if (m_uploaded_elements != 0) {
+        vertex_array.render_indirect(mode, elements());
+    }
+
+    if (m_uploaded_arrays != 0) {
+        vertex_array.render_indirect(mode, arrays());
+    }
+}
@@ -0,0 +1,74 @@
+#include <glimpse/fence.hpp>
+
+#include <GL/glew.h>
+
+gl::Fence::Fence(void* sync) noexcept : m_sync(sync) {}
+
+gl::Fence gl::Fence::insert() {
+    GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    if (!sync) {
+        throw gl::Error(glGetError());
+    }
+
+    return Fence(sync);
+}
+
+gl::Fence::~Fence() noexcept {
+    reset();
+}
+
+void gl::Fence::reset() noexcept {
+    if (this->operator bool()) {
+        glDeleteSync(static_cast<GLsync>(m_sync));
+        m_sync = nullptr;
+    }
+}
+
+void gl::Fence::swap(gl::Fence& other) noexcept {
+    std::swap(m_sync, other.m_sync);
+}
+
+gl::Fence::Fence(gl::Fence&& other) noexcept {
+    swap(other);
+}
+
+gl::Fence& gl::Fence::operator=(gl::Fence&& other) noexcept {
+    swap(other);
+    return *this;
+}
+
+gl::Fence& gl::Fence::operator=(std::nullptr_t) {
+    reset();
+    return *this;
+}
+
+gl::Fence::operator bool() const noexcept {
+    return m_sync != nullptr;
+}
+
+bool gl::Fence::signaled() const {
+    return wait(0);
+}
+
+bool gl::Fence::wait(std::uint64_t timeout) const {
+    if (!this->operator bool()) {
+        return true;
+    }
+
+    GLenum status = glClientWaitSync(static_cast<GLsync>(m_sync), GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+    switch (status) {
+        case GL_ALREADY_SIGNALED:
+        case GL_CONDITION_SATISFIED:
+            return true;
+        case GL_TIMEOUT_EXPIRED:
+            return false;
+        default:
+            throw gl::Error(glGetError());
+    }
+}
+
+void* gl::Fence::native_handle() const noexcept {
+    return m_sync;
+}
@@ -1,7 +1,10 @@
 #include <glimpse/framebuffer.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
+#include <cassert>
 #include <stdexcept>
 
 gl::Framebuffer::Framebuffer(const std::vector<ColorAttachment>& color_attachments,
@@ -156,6 +159,11 @@ gl::Framebuffer::Framebuffer(const std::vector<ColorAttachment>& color_attachmen
         m_draw_buffers[i] = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
     }
 
+    // The draw buffers are state of the framebuffer object, so they only need to be set once
+    if (!m_draw_buffers.empty()) {
+        glNamedFramebufferDrawBuffers(m_handle, static_cast<GLsizei>(m_draw_buffers.size()), m_draw_buffers.data());
+    }
+
     m_color_mask.resize(color_attachments.size() * 4 + 1);
 
     for (size_t i = 0; i < color_attachments.size(); i++) {
@@ -176,9 +184,13 @@ gl::Framebuffer::Framebuffer(const std::vector<ColorAttachment>& color_attachmen
     }
 }
 
+gl::Framebuffer::~Framebuffer() noexcept {
+    reset();
+}
+
 void gl::Framebuffer::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteFramebuffers(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::FRAMEBUFFER, m_handle);
         m_handle = INVALID;
     }
 }
@@ -205,67 +217,140 @@ gl::Framebuffer& gl::Framebuffer::operator=(gl::Framebuffer&& other) noexcept {
     return *this;
 }
 
+gl::Framebuffer& gl::Framebuffer::operator=(std::nullptr_t) {
+    reset();
+    return *this;
+}
+
+gl::Framebuffer::operator bool() const noexcept {
+    return m_handle != INVALID;
+}
+
+int gl::Framebuffer::width() const noexcept {
+    return m_width;
+}
+
+int gl::Framebuffer::height() const noexcept {
+    return m_height;
+}
+
+int gl::Framebuffer::samples() const noexcept {
+    return m_samples;
+}
+
+const std::vector<gl::Framebuffer::ColorAttachment>& gl::Framebuffer::color_attachments() const noexcept {
+    return m_color_attachments;
+}
+
+const gl::Framebuffer::DepthAttachment& gl::Framebuffer::depth_attachment() const noexcept {
+    return m_depth_attachment;
+}
+
+bool gl::Framebuffer::has_depth_attachment() const noexcept {
+    return !std::holds_alternative<std::monostate>(m_depth_attachment);
+}
+
+const glm::ivec4& gl::Framebuffer::viewport() const noexcept {
+    return m_viewport;
+}
+
+glm::ivec4& gl::Framebuffer::viewport() noexcept {
+    return m_viewport;
+}
+
+const std::optional<glm::ivec4>& gl::Framebuffer::scissor() const noexcept {
+    return m_scissor;
+}
+
+std::optional<glm::ivec4>& gl::Framebuffer::scissor() noexcept {
+    return m_scissor;
+}
+
+gl::Handle gl::Framebuffer::native_handle() const noexcept {
+    return m_handle;
+}
+
+void gl::Framebuffer::clear(const glm::vec4& color, float depth) noexcept {
+    clear(color, depth, nullptr);
+}
+
+void gl::Framebuffer::clear(const glm::vec4& color, float depth, const glm::ivec4& viewport) noexcept {
+    clear(color, depth, &viewport);
+}
+
 void gl::Framebuffer::clear(const glm::vec4& color, float depth, const glm::ivec4* viewport) noexcept {
     assert(this->operator bool());
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_handle);
-    glDrawBuffers(m_draw_buffers.size(), m_draw_buffers.data());
+    gl::State& state = gl::State::current();
 
-    glClearColor(color[0], color[1], color[2], color[3]);
-    glClearDepth(depth);
+    // Clears are subject to the write masks and the scissor box, but not to the viewport
+    set_masks();
 
-    for (size_t i = 0; i < m_draw_buffers.size(); i++) {
-        glColorMaski(i, m_color_mask[i * 4 + 0], m_color_mask[i * 4 + 1], m_color_mask[i * 4 + 2],
-                     m_color_mask[i * 4 + 3]);
+    if (viewport) {
+        state.set_enabled(GL_SCISSOR_TEST, true);
+        state.set_scissor((*viewport)[0], (*viewport)[1], (*viewport)[2], (*viewport)[3]);
+    } else if (m_scissor) {
+        state.set_enabled(GL_SCISSOR_TEST, true);
+        state.set_scissor((*m_scissor)[0], (*m_scissor)[1], (*m_scissor)[2], (*m_scissor)[3]);
+    } else {
+        state.set_enabled(GL_SCISSOR_TEST, false);
     }
 
-    glDepthMask(has_depth_attachment());
-
-    // Respect the passed in viewport even with scissor enabled
-    if (viewport) {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor((*viewport)[0], (*viewport)[1], (*viewport)[2], (*viewport)[3]);
-        glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+    // Clear the attachments directly instead of binding the framebuffer
+    const float rgba[4] = {color[0], color[1], color[2], color[3]};
+    for (size_t i = 0; i < m_draw_buffers.size(); i++) {
+        glClearNamedFramebufferfv(m_handle, GL_COLOR, static_cast<GLint>(i), rgba);
+    }
 
-        // restore scissor if enabled
-        if (m_scissor) {
-            glScissor((*m_scissor)[0], (*m_scissor)[1], (*m_scissor)[2], (*m_scissor)[3]);
-        } else {
-            glDisable(GL_SCISSOR_TEST);
-        }
-    } else {
-        // clear with scissor if enabled
-        if (m_scissor) {
-            glEnable(GL_SCISSOR_TEST);
-            glScissor((*m_scissor)[0], (*m_scissor)[1], (*m_scissor)[2], (*m_scissor)[3]);
-        }
-        glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+    if (has_depth_attachment()) {
+        glClearNamedFramebufferfv(m_handle, GL_DEPTH, 0, &depth);
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Restore the scissor box of the framebuffer if it is in use
+    if (viewport && m_scissor) {
+        state.set_scissor((*m_scissor)[0], (*m_scissor)[1], (*m_scissor)[2], (*m_scissor)[3]);
+    } else if (viewport) {
+        state.set_enabled(GL_SCISSOR_TEST, false);
+    }
 }
 
 void gl::Framebuffer::use() {
     assert(this->operator bool());
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_handle);
-    glDrawBuffers(m_draw_buffers.size(), m_draw_buffers.data());
+    gl::State& state = gl::State::current();
+    state.bind_framebuffer(m_handle);
 
     if (m_viewport[2] && m_viewport[3]) {
-        glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+        state.set_viewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
     }
 
     if (m_scissor) {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor((*m_scissor)[0], (*m_scissor)[1], (*m_scissor)[2], (*m_scissor)[3]);
+        state.set_enabled(GL_SCISSOR_TEST, true);
+        state.set_scissor((*m_scissor)[0], (*m_scissor)[1], (*m_scissor)[2], (*m_scissor)[3]);
     } else {
-        glDisable(GL_SCISSOR_TEST);
+        state.set_enabled(GL_SCISSOR_TEST, false);
     }
 
+    set_masks();
+}
+
+void gl::Framebuffer::set_masks() const noexcept {
+    gl::State& state = gl::State::current();
+
     for (size_t i = 0; i < m_draw_buffers.size(); i++) {
-        glColorMaski(i, m_color_mask[i * 4 + 0], m_color_mask[i * 4 + 1], m_color_mask[i * 4 + 2],
-                     m_color_mask[i * 4 + 3]);
+        state.set_color_mask(static_cast<unsigned>(i), m_color_mask[i * 4 + 0], m_color_mask[i * 4 + 1],
+                             m_color_mask[i * 4 + 2], m_color_mask[i * 4 + 3]);
     }
 
-    glDepthMask(has_depth_attachment());
+    state.set_depth_mask(has_depth_attachment());
+}
+
+gl::Framebuffer gl::Framebuffer::simple(int width,
+                                        int height,
+                                        int components,
+                                        const gl::PixelType& dtype,
+                                        int samples) {
+    auto color = std::make_shared<gl::Renderbuffer>(width, height, components, dtype, samples);
+    auto depth = std::make_shared<gl::Renderbuffer>(gl::Renderbuffer::depth(width, height, 1, samples));
+    return Framebuffer({color}, depth);
 }
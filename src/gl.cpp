@@ -0,0 +1,16 @@
+#include <glimpse/gl.hpp>
+
+gl::ElementDescriptor::ElementDescriptor(gl::Type type, size_t size, size_t count) noexcept
+    : m_type(type), m_size(size), m_count(count) {}
+
+gl::Type gl::ElementDescriptor::type() const noexcept {
+    return m_type;
+}
+
+size_t gl::ElementDescriptor::size() const noexcept {
+    return m_size;
+}
+
+size_t gl::ElementDescriptor::count() const noexcept {
+    return m_count;
+}
@@ -1,19 +1,29 @@
 #include <glimpse/gl.hpp>
 #include <glimpse/program.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 static bool checkShaderErrors(GLuint shader);
 static bool checkProgramErrors(GLuint program);
 static std::string readFile(std::filesystem::path filePath);
 
-gl::Program::Program(unsigned handle) : m_handle(handle) {
+gl::Program::Program(unsigned handle, bool reflect) : m_handle(handle) {
+    if (reflect) {
+        this->reflect();
+    }
+}
+
+void gl::Program::reflect() {
     {
         GLint num_uniforms = 0;
         glGetProgramiv(m_handle, GL_ACTIVE_UNIFORMS, &num_uniforms);
@@ -67,11 +77,116 @@ gl::Program::Program(unsigned handle) : m_handle(handle) {
             }
         }
     }
+
+    {
+        GLint num_blocks = 0;
+        glGetProgramiv(m_handle, GL_ACTIVE_UNIFORM_BLOCKS, &num_blocks);
+
+        if (num_blocks != 0) {
+            GLint max_name_len = 0;
+            GLsizei length = 0;
+            GLint binding = 0;
+            GLint size = 0;
+            glGetProgramiv(m_handle, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_name_len);
+            auto block_name = std::make_unique<char[]>(static_cast<size_t>(max_name_len));
+
+            for (GLuint i = 0; i < static_cast<GLuint>(num_blocks); i++) {
+                glGetActiveUniformBlockName(m_handle, i, max_name_len, &length, block_name.get());
+                glGetActiveUniformBlockiv(m_handle, i, GL_UNIFORM_BLOCK_BINDING, &binding);
+                glGetActiveUniformBlockiv(m_handle, i, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+
+                std::string str_name(block_name.get(), static_cast<size_t>(length));
+                uniform_blocks[str_name] = gl::Block(m_handle, str_name, gl::Block::Kind::UNIFORM, i,
+                                                     static_cast<unsigned>(binding), static_cast<size_t>(size));
+            }
+        }
+    }
+
+    {
+        GLint num_blocks = 0;
+        glGetProgramInterfaceiv(m_handle, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &num_blocks);
+
+        if (num_blocks != 0) {
+            GLint max_name_len = 0;
+            GLsizei length = 0;
+            const GLenum properties[] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+            GLint values[2] = {};
+            glGetProgramInterfaceiv(m_handle, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &max_name_len);
+            auto block_name = std::make_unique<char[]>(static_cast<size_t>(max_name_len));
+
+            for (GLuint i = 0; i < static_cast<GLuint>(num_blocks); i++) {
+                glGetProgramResourceName(m_handle, GL_SHADER_STORAGE_BLOCK, i, max_name_len, &length, block_name.get());
+                glGetProgramResourceiv(m_handle, GL_SHADER_STORAGE_BLOCK, i, 2, properties, 2, nullptr, values);
+
+                std::string str_name(block_name.get(), static_cast<size_t>(length));
+                storage_blocks[str_name] = gl::Block(m_handle, str_name, gl::Block::Kind::SHADER_STORAGE, i,
+                                                     static_cast<unsigned>(values[0]), static_cast<size_t>(values[1]));
+            }
+        }
+    }
+
+    index();
+}
+
+void gl::Program::index() {
+    // The maps never rehash their nodes away, so pointers into them stay valid as long as no member is erased
+    m_uniform_table.clear();
+    for (auto& [name, uniform] : uniforms) {
+        m_uniform_table.emplace_back(gl::Name::fnv1a(name), &uniform);
+    }
+    std::sort(m_uniform_table.begin(), m_uniform_table.end());
+
+    m_attribute_table.clear();
+    for (const auto& [name, attribute] : attributes) {
+        m_attribute_table.emplace_back(gl::Name::fnv1a(name), &attribute);
+    }
+    std::sort(m_attribute_table.begin(), m_attribute_table.end());
+
+    m_uniform_shadow = std::make_unique<gl::UniformShadow>(uniforms);
+}
+
+template <typename T>
+T* gl::Program::find(const std::vector<std::pair<std::uint64_t, T*>>& table, gl::Name name) noexcept {
+    auto it = std::lower_bound(table.begin(), table.end(), name.hash(),
+                               [](const auto& entry, std::uint64_t hash) { return entry.first < hash; });
+
+    // Compare the names as well, in case two names share a hash
+    for (; it != table.end() && it->first == name.hash(); ++it) {
+        if (it->second->name() == name.str()) {
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+gl::UniformHandle gl::Program::uniform(gl::Name name) noexcept {
+    return gl::UniformHandle(find(m_uniform_table, name));
+}
+
+const gl::Attribute* gl::Program::attribute(gl::Name name) const noexcept {
+    return find(m_attribute_table, name);
+}
+
+gl::Program::~Program() noexcept {
+    reset();
+}
+
+gl::Program& gl::Program::operator=(std::nullptr_t) {
+    reset();
+    return *this;
+}
+
+gl::Program::operator bool() const noexcept {
+    return m_handle != INVALID;
+}
+
+gl::Handle gl::Program::native_handle() const noexcept {
+    return m_handle;
 }
 
 void gl::Program::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteProgram(m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::PROGRAM, m_handle);
         m_handle = INVALID;
     }
 }
@@ -80,6 +195,11 @@ void gl::Program::swap(gl::Program& other) noexcept {
     std::swap(m_handle, other.m_handle);
     std::swap(uniforms, other.uniforms);
     std::swap(attributes, other.attributes);
+    std::swap(uniform_blocks, other.uniform_blocks);
+    std::swap(storage_blocks, other.storage_blocks);
+    std::swap(m_uniform_table, other.m_uniform_table);
+    std::swap(m_attribute_table, other.m_attribute_table);
+    std::swap(m_uniform_shadow, other.m_uniform_shadow);
 }
 
 gl::Program::Program(gl::Program&& other) noexcept {
@@ -91,12 +211,117 @@ gl::Program& gl::Program::operator=(gl::Program&& other) noexcept {
     return *this;
 }
 
+gl::UniformShadow::Statistics gl::Program::uniform_statistics() const noexcept {
+    return m_uniform_shadow ? m_uniform_shadow->statistics() : gl::UniformShadow::Statistics{};
+}
+
+void gl::Program::invalidate_uniforms() noexcept {
+    if (m_uniform_shadow) {
+        m_uniform_shadow->invalidate();
+    }
+}
+
 void gl::Program::use() const noexcept {
-    glUseProgram(native_handle());
+    gl::State::current().use_program(native_handle());
 }
 
-gl::ProgramBuilder::~ProgramBuilder() {
-    freeStages();
+glm::uvec3 gl::Program::work_group_size() const noexcept {
+    GLint size[3] = {0, 0, 0};
+    glGetProgramiv(m_handle, GL_COMPUTE_WORK_GROUP_SIZE, size);
+    return glm::uvec3(size[0], size[1], size[2]);
+}
+
+void gl::Program::dispatch(unsigned x, unsigned y, unsigned z, gl::Barrier barrier) const noexcept {
+    use();
+    glDispatchCompute(x, y, z);
+    gl::memory_barrier(barrier);
+}
+
+void gl::Program::dispatch_indirect(const gl::Data& commands, size_t index, gl::Barrier barrier) const {
+    if (commands.slice().stride() != sizeof(gl::DispatchIndirectCommand)) {
+        throw std::invalid_argument("The commands must be tightly packed dispatch commands");
+    } else if (index >= commands.size()) {
+        throw std::out_of_range("The dispatch command is out of range");
+    }
+
+    use();
+    gl::State::current().bind_buffer(GL_DISPATCH_INDIRECT_BUFFER, commands.buffer().native_handle());
+    glDispatchComputeIndirect(static_cast<GLintptr>(commands.slice().start() + index * commands.slice().stride()));
+    gl::memory_barrier(barrier);
+}
+
+gl::PendingProgram::PendingProgram(gl::Program program) noexcept : m_program(std::move(program)) {}
+
+gl::PendingProgram::PendingProgram(gl::Program program,
+                                   std::vector<unsigned> stages,
+                                   std::shared_ptr<gl::ProgramCache> cache,
+                                   std::uint64_t key) noexcept
+    : m_program(std::move(program)), m_stages(std::move(stages)), m_cache(std::move(cache)), m_key(key),
+      m_pending(true) {}
+
+gl::PendingProgram::~PendingProgram() noexcept {
+    free_stages();
+}
+
+gl::PendingProgram& gl::PendingProgram::operator=(gl::PendingProgram&& other) noexcept {
+    if (this != &other) {
+        // Delete the stages of the replaced program, the program itself is deleted along with the other object
+        free_stages();
+        m_program = std::move(other.m_program);
+        m_stages.swap(other.m_stages);
+        m_cache = std::move(other.m_cache);
+        m_key = other.m_key;
+        m_pending = other.m_pending;
+    }
+    return *this;
+}
+
+bool gl::PendingProgram::ready() const noexcept {
+    if (!m_pending || !gl::ProgramBuilder::parallel_compile()) {
+        return true;
+    }
+
+    // Linking completes after the stages compiled, so the program status covers them
+    GLint completed = GL_FALSE;
+    glGetProgramiv(m_program.native_handle(), GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+gl::Program gl::PendingProgram::get() {
+    if (!m_program) {
+        throw std::logic_error("The program was already obtained");
+    } else if (!m_pending) {
+        return std::move(m_program);
+    }
+    m_pending = false;
+
+    // A failed program is released, so that obtaining it again throws instead of returning it
+    for (GLuint shader : m_stages) {
+        if (!checkShaderErrors(shader)) {
+            free_stages();
+            m_program = nullptr;
+            throw ProgramLoadingException("Failed to compile shader {}");
+        }
+    }
+    free_stages();
+
+    if (!checkProgramErrors(m_program.native_handle())) {
+        m_program = nullptr;
+        throw ProgramLoadingException("Shader program failed to link");
+    }
+
+    m_program.reflect();
+    if (m_cache) {
+        m_cache->store(m_key, m_program);
+    }
+    return std::move(m_program);
+}
+
+void gl::PendingProgram::free_stages() noexcept {
+    for (GLuint shader : m_stages) {
+        glDeleteShader(shader);
+    }
+    m_stages.clear();
 }
 
 gl::ProgramBuilder& gl::ProgramBuilder::add_stage(unsigned stage, std::filesystem::path path) {
@@ -104,40 +329,81 @@ gl::ProgramBuilder& gl::ProgramBuilder::add_stage(unsigned stage, std::filesyste
         throw ProgramLoadingException("File does not exist");
     }
 
-    const std::string shaderSource = readFile(path);
-    const GLuint shader = glCreateShader(stage);
-    const char* shaderSourcePtr = shaderSource.c_str();
-    glShaderSource(shader, 1, &shaderSourcePtr, nullptr);
-    glCompileShader(shader);
-    if (!checkShaderErrors(shader)) {
-        glDeleteShader(shader);
-        throw ProgramLoadingException("Failed to compile shader {}");
-    }
+    return add_source(stage, readFile(path));
+}
+
+gl::ProgramBuilder& gl::ProgramBuilder::add_source(unsigned stage, const std::string& source) {
+    m_sources.emplace_back(stage, source);
+    return *this;
+}
 
-    m_stages.push_back(shader);
+gl::ProgramBuilder& gl::ProgramBuilder::capture(std::vector<std::string> varyings, bool interleaved) {
+    m_varyings = std::move(varyings);
+    m_interleaved = interleaved;
+    return *this;
+}
+
+gl::ProgramBuilder& gl::ProgramBuilder::cache(std::shared_ptr<gl::ProgramCache> cache) {
+    m_cache = std::move(cache);
     return *this;
 }
 
 gl::Program gl::ProgramBuilder::build() {
+    return build_async().get();
+}
+
+gl::PendingProgram gl::ProgramBuilder::build_async() {
+    std::uint64_t key = 0;
+    if (m_cache) {
+        key = m_cache->key(m_sources, m_varyings, m_interleaved);
+        if (std::optional<gl::Program> program = m_cache->load(key)) {
+            m_sources.clear();
+            return PendingProgram(std::move(*program));
+        }
+    }
+
+    // Errors are checked when the program is obtained, checking here would wait for the compiler
+    std::vector<unsigned> stages;
+    for (const auto& [stage, source] : m_sources) {
+        const GLuint shader = glCreateShader(stage);
+        const char* shaderSourcePtr = source.c_str();
+        glShaderSource(shader, 1, &shaderSourcePtr, nullptr);
+        glCompileShader(shader);
+        stages.push_back(shader);
+    }
+    m_sources.clear();
+
     // Combine vertex and fragment shaders into a single shader program.
     unsigned handle = glCreateProgram();
 
-    for (GLuint shader : m_stages) {
+    for (GLuint shader : stages) {
         glAttachShader(handle, shader);
     }
-    glLinkProgram(handle);
-    freeStages();
 
-    if (!checkProgramErrors(handle)) {
-        throw ProgramLoadingException("Shader program failed to link");
+    if (!m_varyings.empty()) {
+        std::vector<const char*> varyings;
+        for (const std::string& varying : m_varyings) {
+            varyings.push_back(varying.c_str());
+        }
+        glTransformFeedbackVaryings(handle, static_cast<GLsizei>(varyings.size()), varyings.data(),
+                                    m_interleaved ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS);
     }
+    if (m_cache) {
+        glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(handle);
 
-    return Program(handle);
+    // The pending program owns the stages until their errors are checked
+    return PendingProgram(Program(handle, false), std::move(stages), m_cache, key);
 }
 
-void gl::ProgramBuilder::freeStages() {
-    for (GLuint shader : m_stages) {
-        glDeleteShader(shader);
+bool gl::ProgramBuilder::parallel_compile() noexcept {
+    return GLEW_KHR_parallel_shader_compile;
+}
+
+void gl::ProgramBuilder::set_compiler_threads(unsigned count) noexcept {
+    if (parallel_compile()) {
+        glMaxShaderCompilerThreadsKHR(count);
     }
 }
 
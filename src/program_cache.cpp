@@ -0,0 +1,310 @@
+#include <glimpse/program_cache.hpp>
+#include <glimpse/name.hpp>
+#include <glimpse/program.hpp>
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <system_error>
+
+static constexpr std::uint32_t MAGIC = 0x43504C47;  // "GLPC"
+static constexpr std::uint32_t VERSION = 1;
+
+template <typename T>
+static std::uint64_t hash_value(const T& value, std::uint64_t hash) noexcept;
+static std::uint64_t hash_value(const std::string& value, std::uint64_t hash) noexcept;
+
+namespace {
+/**
+ * Writes values to a binary file in native byte order.
+ */
+class Writer {
+public:
+    explicit Writer(std::ofstream& file) noexcept : m_file(file) {}
+
+    template <typename T>
+    void write(const T& value) {
+        m_file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write(const std::string& value) {
+        write(static_cast<std::uint32_t>(value.size()));
+        m_file.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+private:
+    std::ofstream& m_file;
+};
+
+/**
+ * Reads values written by a {@link Writer} from a buffer, failing instead of
+ * reading past its end.
+ */
+class Reader {
+public:
+    explicit Reader(const std::vector<char>& buffer) noexcept : m_buffer(buffer) {}
+
+    template <typename T>
+    bool read(T& value) noexcept {
+        return read(&value, sizeof(T));
+    }
+
+    bool read(std::string& value) {
+        std::uint32_t size = 0;
+        if (!read(size) || size > m_buffer.size() - m_offset) {
+            return false;
+        }
+        value.assign(m_buffer.data() + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    bool read(void* data, size_t size) noexcept {
+        if (size > m_buffer.size() - m_offset) {
+            return false;
+        }
+        std::memcpy(data, m_buffer.data() + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+private:
+    const std::vector<char>& m_buffer;
+    size_t m_offset{0};
+};
+}  // namespace
+
+static void write_blocks(Writer& writer, const std::unordered_map<std::string, gl::Block>& blocks);
+static bool read_blocks(Reader& reader,
+                        gl::Handle handle,
+                        gl::Block::Kind kind,
+                        std::unordered_map<std::string, gl::Block>& blocks);
+
+gl::ProgramCache::ProgramCache(std::filesystem::path directory) : m_directory(std::move(directory)) {
+    std::filesystem::create_directories(m_directory);
+
+    m_driver = gl::Name::fnv1a("");
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const auto* value = reinterpret_cast<const char*>(glGetString(name));
+        m_driver = hash_value(std::string(value ? value : ""), m_driver);
+    }
+}
+
+const std::filesystem::path& gl::ProgramCache::directory() const noexcept {
+    return m_directory;
+}
+
+gl::ProgramCache::Statistics gl::ProgramCache::statistics() const noexcept {
+    return m_statistics;
+}
+
+bool gl::ProgramCache::supported() noexcept {
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+std::uint64_t gl::ProgramCache::key(const std::vector<std::pair<unsigned, std::string>>& sources,
+                                    const std::vector<std::string>& varyings,
+                                    bool interleaved) const noexcept {
+    std::uint64_t hash = m_driver;
+    for (const auto& [stage, source] : sources) {
+        hash = hash_value(stage, hash);
+        hash = hash_value(source, hash);
+    }
+    for (const std::string& varying : varyings) {
+        hash = hash_value(varying, hash);
+    }
+    return hash_value(interleaved, hash);
+}
+
+std::optional<gl::Program> gl::ProgramCache::load(std::uint64_t key) {
+    std::ifstream file(path(key), std::ios::binary);
+    if (!file) {
+        m_statistics.misses++;
+        return std::nullopt;
+    }
+
+    std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reader reader(buffer);
+
+    auto reject = [this, key]() -> std::optional<gl::Program> {
+        std::error_code error;
+        std::filesystem::remove(path(key), error);
+        m_statistics.misses++;
+        return std::nullopt;
+    };
+
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint64_t stored_key = 0;
+    GLenum format = GL_NONE;
+    std::uint64_t length = 0;
+    if (!reader.read(magic) || !reader.read(version) || !reader.read(stored_key) || !reader.read(format) ||
+        !reader.read(length) || magic != MAGIC || version != VERSION || stored_key != key ||
+        length > buffer.size()) {
+        return reject();
+    }
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    if (!reader.read(binary.data(), binary.size())) {
+        return reject();
+    }
+
+    // The driver rejects binaries of another driver or version by failing to link
+    GLuint handle = glCreateProgram();
+    glProgramBinary(handle, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(handle, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(handle);
+        return reject();
+    }
+
+    gl::Program program(handle, false);
+
+    std::uint32_t count = 0;
+    bool valid = reader.read(count);
+    for (std::uint32_t i = 0; valid && i < count; i++) {
+        std::string name;
+        gl::Type type = 0;
+        int location = 0;
+        int size = 0;
+        valid = reader.read(name) && reader.read(type) && reader.read(location) && reader.read(size);
+        program.uniforms[name] = gl::Uniform(handle, name, type, location, size);
+    }
+
+    valid = valid && reader.read(count);
+    for (std::uint32_t i = 0; valid && i < count; i++) {
+        std::string name;
+        gl::Type type = 0;
+        unsigned location = 0;
+        int size = 0;
+        valid = reader.read(name) && reader.read(type) && reader.read(location) && reader.read(size);
+        program.attributes[name] = gl::Attribute(handle, name, type, location, size);
+    }
+
+    valid = valid && read_blocks(reader, handle, gl::Block::Kind::UNIFORM, program.uniform_blocks) &&
+            read_blocks(reader, handle, gl::Block::Kind::SHADER_STORAGE, program.storage_blocks);
+    if (!valid) {
+        return reject();
+    }
+    program.index();
+
+    m_statistics.hits++;
+    return program;
+}
+
+void gl::ProgramCache::store(std::uint64_t key, const gl::Program& program) const {
+    GLint length = 0;
+    glGetProgramiv(program.native_handle(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = GL_NONE;
+    glGetProgramBinary(program.native_handle(), length, &length, &format, binary.data());
+    binary.resize(static_cast<size_t>(length));
+
+    // Write to a temporary file first, so other processes never read a partial binary. The name is unique, so
+    // processes storing the same program at once do not write into the same file.
+    std::filesystem::path target = path(key);
+    std::filesystem::path temporary = target;
+    temporary += "." + std::to_string(std::random_device()()) + ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        Writer writer(file);
+        writer.write(MAGIC);
+        writer.write(VERSION);
+        writer.write(key);
+        writer.write(format);
+        writer.write(static_cast<std::uint64_t>(binary.size()));
+        file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+
+        writer.write(static_cast<std::uint32_t>(program.uniforms.size()));
+        for (const auto& [name, uniform] : program.uniforms) {
+            writer.write(name);
+            writer.write(uniform.type());
+            writer.write(uniform.location());
+            writer.write(uniform.count());
+        }
+
+        writer.write(static_cast<std::uint32_t>(program.attributes.size()));
+        for (const auto& [name, attribute] : program.attributes) {
+            writer.write(name);
+            writer.write(attribute.type());
+            writer.write(attribute.location());
+            writer.write(attribute.count());
+        }
+
+        write_blocks(writer, program.uniform_blocks);
+        write_blocks(writer, program.storage_blocks);
+
+        if (!file) {
+            return;
+        }
+    }
+
+    // The cache is an optimization, so failing to store a binary is not an error
+    std::error_code error;
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+std::filesystem::path gl::ProgramCache::path(std::uint64_t key) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return m_directory / name;
+}
+
+static void write_blocks(Writer& writer, const std::unordered_map<std::string, gl::Block>& blocks) {
+    writer.write(static_cast<std::uint32_t>(blocks.size()));
+    for (const auto& [name, block] : blocks) {
+        writer.write(name);
+        writer.write(block.index());
+        writer.write(block.binding());
+        writer.write(static_cast<std::uint64_t>(block.size()));
+    }
+}
+
+static bool read_blocks(Reader& reader,
+                        gl::Handle handle,
+                        gl::Block::Kind kind,
+                        std::unordered_map<std::string, gl::Block>& blocks) {
+    std::uint32_t count = 0;
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::string name;
+        unsigned index = 0;
+        unsigned binding = 0;
+        std::uint64_t size = 0;
+        if (!reader.read(name) || !reader.read(index) || !reader.read(binding) || !reader.read(size)) {
+            return false;
+        }
+        blocks[name] = gl::Block(handle, name, kind, index, binding, static_cast<size_t>(size));
+    }
+    return true;
+}
+
+template <typename T>
+static std::uint64_t hash_value(const T& value, std::uint64_t hash) noexcept {
+    return gl::Name::fnv1a(std::string_view(reinterpret_cast<const char*>(&value), sizeof(T)), hash);
+}
+
+static std::uint64_t hash_value(const std::string& value, std::uint64_t hash) noexcept {
+    // Hash the length first, so that consecutive strings cannot alias
+    return gl::Name::fnv1a(value, hash_value(static_cast<std::uint64_t>(value.size()), hash));
+}
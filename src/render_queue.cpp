@@ -0,0 +1,206 @@
+#include <glimpse/render_queue.hpp>
+#include <glimpse/state.hpp>
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_map>
+
+// Width of the fields of the sort key, from most to least significant
+static constexpr unsigned LAYER_BITS = 8;
+static constexpr unsigned FRAMEBUFFER_BITS = 8;
+static constexpr unsigned PROGRAM_BITS = 12;
+static constexpr unsigned VERTEX_ARRAY_BITS = 12;
+static constexpr unsigned TEXTURE_BITS = 12;
+static constexpr unsigned DEPTH_BITS = 12;
+
+static_assert(LAYER_BITS + FRAMEBUFFER_BITS + PROGRAM_BITS + VERTEX_ARRAY_BITS + TEXTURE_BITS + DEPTH_BITS == 64,
+              "The fields of the sort key must fill 64 bits");
+
+namespace {
+/**
+ * Assigns dense identifiers to handles in order of first appearance, so that
+ * a handle fits into a narrow field of the sort key.
+ */
+class Identifiers {
+public:
+    explicit Identifiers(unsigned bits) noexcept : m_max((std::uint64_t{1} << bits) - 1) {}
+
+    std::uint64_t operator()(gl::Handle handle) {
+        auto [it, inserted] = m_ids.try_emplace(handle, m_ids.size());
+        // Handles beyond the width of the field share the last identifier, which only costs sorting quality
+        return std::min<std::uint64_t>(it->second, m_max);
+    }
+
+private:
+    std::uint64_t m_max;
+    std::unordered_map<gl::Handle, std::uint64_t> m_ids;
+};
+}  // namespace
+
+void gl::RenderQueue::submit(const gl::RenderQueue::Packet& packet,
+                             std::initializer_list<gl::RenderQueue::TextureBinding> textures,
+                             const gl::UniformBatch* uniforms) {
+    // Packets without a framebuffer render to the one of the previous packet, or the bound one before any is set
+    if (packet.framebuffer) {
+        m_framebuffer = packet.framebuffer;
+    } else if (!m_framebuffer) {
+        m_leading++;
+    }
+
+    m_records.push_back({packet, m_framebuffer, static_cast<std::uint32_t>(m_textures.size()),
+                         static_cast<std::uint32_t>(textures.size()), uniforms});
+    m_textures.insert(m_textures.end(), textures);
+}
+
+size_t gl::RenderQueue::size() const noexcept {
+    return m_records.size();
+}
+
+gl::RenderQueue::Statistics gl::RenderQueue::flush() {
+    compute_keys();
+
+    m_order.resize(m_records.size());
+    for (size_t i = 0; i < m_order.size(); i++) {
+        m_order[i] = static_cast<std::uint32_t>(i);
+    }
+    m_statistics.packets = m_records.size();
+    m_statistics.unsorted_switches = count_switches(m_order);
+
+    // The packets drawn to the framebuffer bound before the flush must precede all framebuffer changes
+    sort(0, m_leading);
+    sort(m_leading, m_order.size());
+    m_statistics.switches = count_switches(m_order);
+
+    gl::State& state = gl::State::current();
+    for (std::uint32_t index : m_order) {
+        const Record& record = m_records[index];
+        const Packet& packet = record.packet;
+
+        if (record.framebuffer) {
+            record.framebuffer->use();
+        }
+
+        // Install the program before writing its uniforms, rendering finds it bound already
+        state.use_program(packet.vertex_array->program().native_handle());
+
+        for (std::uint32_t i = 0; i < record.num_textures; i++) {
+            const TextureBinding& binding = m_textures[record.first_texture + i];
+            state.bind_texture(binding.unit, binding.texture);
+        }
+
+        if (record.uniforms) {
+            record.uniforms->apply();
+        }
+
+        packet.vertex_array->render(packet.mode, packet.vertices, packet.first, packet.base_vertex);
+    }
+
+    m_records.clear();
+    m_framebuffer = nullptr;
+    m_leading = 0;
+    m_textures.clear();
+    return m_statistics;
+}
+
+gl::RenderQueue::Statistics gl::RenderQueue::statistics() const noexcept {
+    return m_statistics;
+}
+
+void gl::RenderQueue::compute_keys() {
+    Identifiers framebuffers(FRAMEBUFFER_BITS);
+    Identifiers programs(PROGRAM_BITS);
+    Identifiers vertex_arrays(VERTEX_ARRAY_BITS);
+    Identifiers textures(TEXTURE_BITS);
+
+    constexpr float max_depth = static_cast<float>((1u << DEPTH_BITS) - 1);
+
+    m_keys.resize(m_records.size());
+    for (size_t i = 0; i < m_records.size(); i++) {
+        const Record& record = m_records[i];
+        const Packet& packet = record.packet;
+
+        std::uint64_t framebuffer = record.framebuffer ? framebuffers(record.framebuffer->native_handle()) + 1 : 0;
+        std::uint64_t program = programs(packet.vertex_array->program().native_handle());
+        std::uint64_t vertex_array = vertex_arrays(packet.vertex_array->native_handle());
+        std::uint64_t texture = record.num_textures > 0 ? textures(m_textures[record.first_texture].texture) : 0;
+        std::uint64_t depth = static_cast<std::uint64_t>(std::lround(std::clamp(packet.depth, 0.0f, 1.0f) * max_depth));
+
+        std::uint64_t key = packet.layer;
+        key = (key << FRAMEBUFFER_BITS) | std::min<std::uint64_t>(framebuffer, (1u << FRAMEBUFFER_BITS) - 1);
+        key = (key << PROGRAM_BITS) | program;
+        key = (key << VERTEX_ARRAY_BITS) | vertex_array;
+        key = (key << TEXTURE_BITS) | texture;
+        key = (key << DEPTH_BITS) | depth;
+        m_keys[i] = key;
+    }
+}
+
+void gl::RenderQueue::sort(size_t first, size_t last) {
+    // Least significant digit radix sort of the keys and the order, one byte per pass
+    size_t n = last - first;
+    m_scratch_keys.resize(m_keys.size());
+    m_scratch_order.resize(m_order.size());
+
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        std::array<size_t, 257> offsets{};
+        for (size_t i = first; i < last; i++) {
+            offsets[((m_keys[i] >> shift) & 0xFF) + 1]++;
+        }
+
+        // Skip passes where all keys share the digit, which is common for the upper fields
+        if (std::any_of(offsets.begin(), offsets.end(), [n](size_t count) { return count == n; })) {
+            continue;
+        }
+
+        offsets[0] = first;
+        for (size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        for (size_t i = first; i < last; i++) {
+            size_t target = offsets[(m_keys[i] >> shift) & 0xFF]++;
+            m_scratch_keys[target] = m_keys[i];
+            m_scratch_order[target] = m_order[i];
+        }
+
+        // Only the range was written to the scratch buffers, so copy it back instead of swapping
+        std::copy(m_scratch_keys.begin() + first, m_scratch_keys.begin() + last, m_keys.begin() + first);
+        std::copy(m_scratch_order.begin() + first, m_scratch_order.begin() + last, m_order.begin() + first);
+    }
+}
+
+size_t gl::RenderQueue::count_switches(const std::vector<std::uint32_t>& order) const {
+    size_t switches = 0;
+    gl::Handle framebuffer = INVALID;
+    gl::Handle program = INVALID;
+    gl::Handle vertex_array = INVALID;
+    std::unordered_map<unsigned, gl::Handle> textures;
+
+    auto change = [&switches](gl::Handle& current, gl::Handle handle) {
+        if (current != handle) {
+            current = handle;
+            switches++;
+        }
+    };
+
+    for (std::uint32_t index : order) {
+        const Record& record = m_records[index];
+        const Packet& packet = record.packet;
+
+        if (record.framebuffer) {
+            change(framebuffer, record.framebuffer->native_handle());
+        }
+        change(program, packet.vertex_array->program().native_handle());
+        change(vertex_array, packet.vertex_array->native_handle());
+
+        for (std::uint32_t i = 0; i < record.num_textures; i++) {
+            const TextureBinding& binding = m_textures[record.first_texture + i];
+            auto [it, inserted] = textures.try_emplace(binding.unit, INVALID);
+            change(it->second, binding.texture);
+        }
+    }
+    return switches;
+}
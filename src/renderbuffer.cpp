@@ -1,4 +1,5 @@
 #include <glimpse/renderbuffer.hpp>
+#include <glimpse/deletion_queue.hpp>
 
 #include <GL/glew.h>
 
@@ -36,7 +37,7 @@ gl::Renderbuffer::Renderbuffer(int width,
 
 void gl::Renderbuffer::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteRenderbuffers(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::RENDERBUFFER, m_handle);
         m_handle = INVALID;
     }
 }
@@ -0,0 +1,78 @@
+#include <glimpse/resource_loader.hpp>
+
+#include <GL/glew.h>
+
+std::shared_future<std::shared_ptr<gl::Program>> gl::ResourceLoader::program(
+    std::vector<std::pair<unsigned, std::string>> stages) {
+    return push(m_programs, ProgramRequest{std::move(stages), {}});
+}
+
+size_t gl::ResourceLoader::pending() const noexcept {
+    return m_buffers.size() + m_textures.size() + m_programs.size();
+}
+
+size_t gl::ResourceLoader::materialize() {
+    std::vector<BufferRequest> buffers = m_buffers.drain();
+    std::vector<TextureRequest> textures = m_textures.drain();
+    std::vector<ProgramRequest> programs = m_programs.drain();
+
+    if (!buffers.empty()) {
+        std::vector<gl::Handle> handles(buffers.size());
+        glCreateBuffers(static_cast<GLsizei>(handles.size()), handles.data());
+
+        for (size_t i = 0; i < buffers.size(); i++) {
+            BufferRequest& request = buffers[i];
+
+            try {
+                auto buffer = request.immutable
+                                  ? std::make_shared<gl::Buffer>(
+                                        gl::Buffer(handles[i], request.data, request.size, request.storage))
+                                  : std::make_shared<gl::Buffer>(
+                                        gl::Buffer(handles[i], request.data, request.size, request.type));
+                request.owner = nullptr;
+                request.promise.set_value(std::move(buffer));
+            } catch (...) {
+                // The buffer was rejected before taking ownership of the handle
+                glDeleteBuffers(1, &handles[i]);
+                request.promise.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    if (!textures.empty()) {
+        std::vector<gl::Handle> handles(textures.size());
+        glCreateTextures(GL_TEXTURE_2D, static_cast<GLsizei>(handles.size()), handles.data());
+
+        for (size_t i = 0; i < textures.size(); i++) {
+            TextureRequest& request = textures[i];
+
+            try {
+                auto texture = std::make_shared<gl::Texture>(gl::Texture(request.width, request.height,
+                                                                         request.components, false, *request.dtype,
+                                                                         request.data, 0, request.alignment,
+                                                                         handles[i]));
+                request.owner = nullptr;
+                request.promise.set_value(std::move(texture));
+            } catch (...) {
+                // The texture was rejected before taking ownership of the handle
+                glDeleteTextures(1, &handles[i]);
+                request.promise.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    // Programs have no batched creation, but are still built here so workers never touch the context
+    for (ProgramRequest& request : programs) {
+        try {
+            gl::ProgramBuilder builder;
+            for (const auto& [stage, source] : request.stages) {
+                builder.add_source(stage, source);
+            }
+            request.promise.set_value(std::make_shared<gl::Program>(builder.build()));
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+    }
+
+    return buffers.size() + textures.size() + programs.size();
+}
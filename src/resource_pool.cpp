@@ -0,0 +1,208 @@
+#include <glimpse/resource_pool.hpp>
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+/**
+ * The key that identifies interchangeable resources.
+ */
+struct Key {
+    bool texture;
+    size_t size;
+    unsigned storage;
+    int width;
+    int height;
+    int components;
+    const gl::PixelType* dtype;
+    int samples;
+    bool depth;
+
+    bool operator<(const Key& other) const noexcept {
+        return std::tie(texture, size, storage, width, height, components, dtype, samples, depth) <
+               std::tie(other.texture, other.size, other.storage, other.width, other.height, other.components,
+                        other.dtype, other.samples, other.depth);
+    }
+};
+
+/**
+ * An idle resource waiting to be handed out again.
+ */
+struct Idle {
+    Key key;
+    size_t bytes;
+    std::unique_ptr<gl::Buffer> buffer;
+    std::unique_ptr<gl::Texture> texture;
+};
+}  // namespace
+
+struct gl::ResourcePool::State {
+    std::mutex mutex;
+    std::list<Idle> lru;
+    std::multimap<Key, std::list<Idle>::iterator> index;
+    size_t capacity;
+    size_t bytes{};
+    size_t hits{};
+    size_t misses{};
+
+    /**
+     * Take an idle resource with the specified key, if any.
+     */
+    std::unique_ptr<Idle> acquire(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = index.find(key);
+        if (it == index.end()) {
+            misses++;
+            return nullptr;
+        }
+
+        auto idle = std::make_unique<Idle>(std::move(*it->second));
+        lru.erase(it->second);
+        index.erase(it);
+        bytes -= idle->bytes;
+        hits++;
+        return idle;
+    }
+
+    /**
+     * Return a resource to the pool.
+     */
+    void recycle(Idle idle) noexcept {
+        std::vector<Idle> evicted;
+
+        try {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            bytes += idle.bytes;
+            lru.push_back(std::move(idle));
+            index.emplace(lru.back().key, std::prev(lru.end()));
+            evicted = evict(capacity);
+        } catch (...) {
+            // The resource is deleted instead when it cannot be tracked
+        }
+    }
+
+    /**
+     * Remove least recently used resources until the idle resources fit in
+     * the specified number of bytes. The caller must hold the lock and
+     * destroy the returned resources after releasing it.
+     */
+    std::vector<Idle> evict(size_t limit) {
+        std::vector<Idle> evicted;
+
+        while (bytes > limit && !lru.empty()) {
+            auto it = lru.begin();
+            auto [first, last] = index.equal_range(it->key);
+            for (auto entry = first; entry != last; ++entry) {
+                if (entry->second == it) {
+                    index.erase(entry);
+                    break;
+                }
+            }
+
+            bytes -= it->bytes;
+            evicted.push_back(std::move(*it));
+            lru.erase(it);
+        }
+
+        return evicted;
+    }
+};
+
+/**
+ * A deleter that returns resources to their pool while it exists.
+ */
+template <typename T>
+struct gl::ResourcePool::Recycler {
+    std::weak_ptr<State> state;
+    Key key;
+    size_t bytes;
+
+    void operator()(T* resource) const noexcept {
+        std::unique_ptr<T> owner(resource);
+
+        if (auto pool = state.lock()) {
+            Idle idle{key, bytes, nullptr, nullptr};
+            if constexpr (std::is_same_v<T, gl::Buffer>) {
+                idle.buffer = std::move(owner);
+            } else {
+                idle.texture = std::move(owner);
+            }
+            pool->recycle(std::move(idle));
+        }
+    }
+};
+
+gl::ResourcePool::ResourcePool(size_t capacity) : m_state(std::make_shared<State>()) {
+    m_state->capacity = capacity;
+}
+
+std::shared_ptr<gl::Buffer> gl::ResourcePool::buffer(size_t size, gl::Buffer::Storage storage) {
+    // Round up to a power of two, so buffers of similar sizes can be shared
+    size_t size_class = 256;
+    while (size_class < size) {
+        size_class <<= 1;
+    }
+
+    Key key{false, size_class, static_cast<unsigned>(storage), 0, 0, 0, nullptr, 0, false};
+    Recycler<gl::Buffer> recycler{m_state, key, size_class};
+
+    if (auto idle = m_state->acquire(key)) {
+        return std::shared_ptr<gl::Buffer>(idle->buffer.release(), recycler);
+    }
+
+    return std::shared_ptr<gl::Buffer>(new gl::Buffer(size_class, storage), recycler);
+}
+
+std::shared_ptr<gl::Texture> gl::ResourcePool::texture(int width,
+                                                       int height,
+                                                       int components,
+                                                       const gl::PixelType& dtype,
+                                                       int samples) {
+    Key key{true, 0, 0, width, height, components, &dtype, samples, false};
+    size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(components) *
+                   dtype.size() * static_cast<size_t>(std::max(samples, 1));
+    Recycler<gl::Texture> recycler{m_state, key, bytes};
+
+    if (auto idle = m_state->acquire(key)) {
+        return std::shared_ptr<gl::Texture>(idle->texture.release(), recycler);
+    }
+
+    auto* texture = new gl::Texture(width, height, components, dtype, static_cast<const void*>(nullptr), samples);
+    return std::shared_ptr<gl::Texture>(texture, recycler);
+}
+
+std::shared_ptr<gl::Texture> gl::ResourcePool::depth(int width, int height, int samples) {
+    Key key{true, 0, 0, width, height, 1, &gl::PixelType::f32, samples, true};
+    size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4 *
+                   static_cast<size_t>(std::max(samples, 1));
+    Recycler<gl::Texture> recycler{m_state, key, bytes};
+
+    if (auto idle = m_state->acquire(key)) {
+        return std::shared_ptr<gl::Texture>(idle->texture.release(), recycler);
+    }
+
+    return std::shared_ptr<gl::Texture>(new gl::Texture(gl::Texture::depth(width, height, samples)), recycler);
+}
+
+size_t gl::ResourcePool::capacity() const noexcept {
+    return m_state->capacity;
+}
+
+void gl::ResourcePool::trim(size_t bytes) {
+    std::vector<Idle> evicted;
+
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    evicted = m_state->evict(bytes);
+}
+
+gl::ResourcePool::Statistics gl::ResourcePool::statistics() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return {m_state->hits, m_state->misses, m_state->lru.size(), m_state->bytes};
+}
@@ -0,0 +1,193 @@
+#include <glimpse/state.hpp>
+
+#include <GL/glew.h>
+
+gl::State& gl::State::current() noexcept {
+    static thread_local State state;
+    return state;
+}
+
+void gl::State::invalidate() noexcept {
+    m_program.reset();
+    m_vertex_array.reset();
+    m_framebuffer.reset();
+    m_transform_feedback.reset();
+    m_buffers.clear();
+    m_ranges.clear();
+    m_textures.fill(std::nullopt);
+    m_capabilities.clear();
+    m_viewport.reset();
+    m_scissor.reset();
+    m_color_masks.fill(std::nullopt);
+    m_depth_mask.reset();
+}
+
+void gl::State::forget(gl::Handle handle) noexcept {
+    auto forget = [handle](std::optional<gl::Handle>& shadow) {
+        if (shadow == handle) {
+            shadow.reset();
+        }
+    };
+
+    forget(m_program);
+    forget(m_vertex_array);
+    forget(m_framebuffer);
+    forget(m_transform_feedback);
+
+    for (auto& [target, buffer] : m_buffers) {
+        forget(buffer);
+    }
+
+    for (auto& [binding, range] : m_ranges) {
+        if (range && std::get<0>(*range) == handle) {
+            range.reset();
+        }
+    }
+
+    for (auto& texture : m_textures) {
+        forget(texture);
+    }
+}
+
+gl::State::Statistics gl::State::statistics() const noexcept {
+    return m_statistics;
+}
+
+void gl::State::reset_statistics() noexcept {
+    m_statistics = {};
+}
+
+void gl::State::use_program(gl::Handle program) noexcept {
+    if (change(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void gl::State::bind_vertex_array(gl::Handle vertex_array) noexcept {
+    if (change(m_vertex_array, vertex_array)) {
+        glBindVertexArray(vertex_array);
+    }
+}
+
+void gl::State::bind_framebuffer(gl::Handle framebuffer) noexcept {
+    if (change(m_framebuffer, framebuffer)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+}
+
+void gl::State::bind_buffer(unsigned target, gl::Handle buffer) noexcept {
+    if (change(m_buffers[target], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void gl::State::bind_buffer_range(unsigned target,
+                                  unsigned index,
+                                  gl::Handle buffer,
+                                  size_t offset,
+                                  size_t size) noexcept {
+    if (!change(m_ranges[{target, index}], Range(buffer, offset, size))) {
+        return;
+    }
+
+    // Binding a range also binds the buffer to the generic binding point of the target
+    m_buffers[target] = buffer;
+
+    if (size == 0) {
+        glBindBufferBase(target, index, buffer);
+    } else {
+        glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+    }
+}
+
+void gl::State::replace_buffer(gl::Handle previous, gl::Handle buffer) noexcept {
+    for (auto& [binding, range] : m_ranges) {
+        if (!range || std::get<0>(*range) != previous) {
+            continue;
+        }
+
+        auto [target, index] = binding;
+        auto [handle, offset, size] = *range;
+        range = Range(buffer, offset, size);
+        m_buffers[target] = buffer;
+        m_statistics.issued++;
+
+        if (size == 0) {
+            glBindBufferBase(target, index, buffer);
+        } else {
+            glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        }
+    }
+
+    for (auto& [target, handle] : m_buffers) {
+        if (handle == previous) {
+            handle = buffer;
+            m_statistics.issued++;
+            glBindBuffer(target, buffer);
+        }
+    }
+}
+
+void gl::State::bind_texture(unsigned unit, gl::Handle texture) noexcept {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        m_statistics.issued++;
+        glBindTextureUnit(unit, texture);
+    } else if (change(m_textures[unit], texture)) {
+        glBindTextureUnit(unit, texture);
+    }
+}
+
+void gl::State::bind_transform_feedback(gl::Handle transform_feedback) noexcept {
+    if (!change(m_transform_feedback, transform_feedback)) {
+        return;
+    }
+
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, transform_feedback);
+
+    // The generic and indexed transform feedback buffer bindings belong to the bound object
+    m_buffers.erase(GL_TRANSFORM_FEEDBACK_BUFFER);
+    for (auto& [binding, range] : m_ranges) {
+        if (binding.first == GL_TRANSFORM_FEEDBACK_BUFFER) {
+            range.reset();
+        }
+    }
+}
+
+void gl::State::set_enabled(unsigned capability, bool enabled) noexcept {
+    if (!change(m_capabilities[capability], enabled)) {
+        return;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void gl::State::set_viewport(int x, int y, int width, int height) noexcept {
+    if (change(m_viewport, Rectangle{x, y, width, height})) {
+        glViewport(x, y, width, height);
+    }
+}
+
+void gl::State::set_scissor(int x, int y, int width, int height) noexcept {
+    if (change(m_scissor, Rectangle{x, y, width, height})) {
+        glScissor(x, y, width, height);
+    }
+}
+
+void gl::State::set_color_mask(unsigned index, bool red, bool green, bool blue, bool alpha) noexcept {
+    if (index >= MAX_DRAW_BUFFERS) {
+        m_statistics.issued++;
+        glColorMaski(index, red, green, blue, alpha);
+    } else if (change(m_color_masks[index], std::array<bool, 4>{red, green, blue, alpha})) {
+        glColorMaski(index, red, green, blue, alpha);
+    }
+}
+
+void gl::State::set_depth_mask(bool enabled) noexcept {
+    if (change(m_depth_mask, enabled)) {
+        glDepthMask(enabled);
+    }
+}
@@ -0,0 +1,97 @@
+#include <glimpse/stream_buffer.hpp>
+
+#include <cassert>
+#include <stdexcept>
+
+gl::StreamBuffer::StreamBuffer(size_t region_size, size_t regions)
+    : m_region_size(region_size), m_regions(regions), m_fences(regions) {
+    if (region_size == 0 || regions == 0) {
+        throw std::invalid_argument("The stream buffer cannot be empty");
+    }
+
+    const size_t size = region_size * regions;
+
+    m_buffer = std::make_shared<gl::Buffer>(size, gl::Buffer::Storage::MAP_WRITE | gl::Buffer::Storage::MAP_PERSISTENT |
+                                                      gl::Buffer::Storage::MAP_COHERENT);
+    m_mapping = m_buffer->map<unsigned char>(
+        size, 0, gl::Buffer::Access::WRITE | gl::Buffer::Access::PERSISTENT | gl::Buffer::Access::COHERENT);
+}
+
+void gl::StreamBuffer::swap(gl::StreamBuffer& other) noexcept {
+    std::swap(m_buffer, other.m_buffer);
+    std::swap(m_mapping, other.m_mapping);
+    std::swap(m_region_size, other.m_region_size);
+    std::swap(m_regions, other.m_regions);
+    std::swap(m_region, other.m_region);
+    std::swap(m_offset, other.m_offset);
+    std::swap(m_fences, other.m_fences);
+}
+
+gl::StreamBuffer::StreamBuffer(gl::StreamBuffer&& other) noexcept {
+    swap(other);
+}
+
+gl::StreamBuffer& gl::StreamBuffer::operator=(gl::StreamBuffer&& other) noexcept {
+    swap(other);
+    return *this;
+}
+
+gl::StreamBuffer::operator bool() const noexcept {
+    return static_cast<bool>(m_mapping);
+}
+
+size_t gl::StreamBuffer::size() const noexcept {
+    return m_region_size * m_regions;
+}
+
+size_t gl::StreamBuffer::region_size() const noexcept {
+    return m_region_size;
+}
+
+size_t gl::StreamBuffer::regions() const noexcept {
+    return m_regions;
+}
+
+size_t gl::StreamBuffer::available() const noexcept {
+    return m_region_size - m_offset;
+}
+
+const std::shared_ptr<gl::Buffer>& gl::StreamBuffer::buffer() const noexcept {
+    return m_buffer;
+}
+
+gl::StreamBuffer::Allocation gl::StreamBuffer::allocate(size_t size,
+                                                        size_t stride,
+                                                        gl::ElementDescriptor descriptor,
+                                                        size_t alignment) {
+    assert(this->operator bool());
+
+    if (alignment == 0 || (alignment & (alignment - 1))) {
+        throw std::invalid_argument("Alignment must be a power of two");
+    }
+
+    // Region boundaries are not necessarily aligned, so align the absolute offset
+    const size_t base = m_region * m_region_size;
+    const size_t start = (base + m_offset + alignment - 1) & ~(alignment - 1);
+
+    if (start + size > base + m_region_size) {
+        throw std::length_error("Stream buffer region is exhausted");
+    }
+
+    m_offset = start + size - base;
+
+    std::slice slice(start, size, stride > 0 ? stride : 1);
+    return {gl::Data(m_buffer, slice, descriptor), m_mapping.data() + start};
+}
+
+void gl::StreamBuffer::next_frame() {
+    assert(this->operator bool());
+
+    m_fences[m_region] = gl::Fence::insert();
+    m_region = (m_region + 1) % m_regions;
+    m_offset = 0;
+
+    // Wait for the GPU to finish reading from the region we are about to overwrite
+    m_fences[m_region].wait();
+    m_fences[m_region] = nullptr;
+}
@@ -1,5 +1,7 @@
 #include <glimpse/gl.hpp>
 #include <glimpse/texture.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
@@ -13,7 +15,8 @@ gl::Texture::Texture(int width,
                      const gl::PixelType& dtype,
                      const void* data,
                      int samples,
-                     int alignment)
+                     int alignment,
+                     gl::Handle handle)
     : m_width(width),
       m_height(height),
       m_components(components),
@@ -42,7 +45,11 @@ gl::Texture::Texture(int width,
     auto [base_format, internal_format] = dtype.format(components);
     GLenum texture_target = m_samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
 
-    glCreateTextures(texture_target, 1, &m_handle);
+    if (handle == INVALID) {
+        glCreateTextures(texture_target, 1, &m_handle);
+    } else {
+        m_handle = handle;
+    }
 
     if (samples) {
         glTextureStorage2DMultisample(m_handle, samples, depth ? GL_DEPTH_COMPONENT24 : internal_format, width, height,
@@ -67,7 +74,7 @@ gl::Texture::Texture(int width,
 
 void gl::Texture::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteTextures(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::TEXTURE, m_handle);
         m_handle = INVALID;
     }
 }
@@ -128,5 +135,5 @@ void gl::Texture::write(const void* data, size_t size, int level, int alignment)
 void gl::Texture::use(unsigned slot) {
     assert(this->operator bool());
 
-    glBindTextureUnit(slot, m_handle);
+    gl::State::current().bind_texture(slot, m_handle);
 }
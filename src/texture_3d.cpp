@@ -1,5 +1,7 @@
 #include <glimpse/gl.hpp>
 #include <glimpse/texture.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
@@ -45,7 +47,7 @@ gl::Texture3D::Texture3D(int width,
 
 void gl::Texture3D::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteTextures(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::TEXTURE, m_handle);
         m_handle = INVALID;
     }
 }
@@ -71,5 +73,5 @@ gl::Texture3D& gl::Texture3D::operator=(gl::Texture3D&& other) noexcept {
 void gl::Texture3D::use(unsigned slot) {
     assert(this->operator bool());
 
-    glBindTextureUnit(slot, m_handle);
+    gl::State::current().bind_texture(slot, m_handle);
 }
@@ -1,5 +1,7 @@
 #include <glimpse/gl.hpp>
 #include <glimpse/texture.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
@@ -58,7 +60,7 @@ gl::TextureArray::TextureArray(int width,
 
 void gl::TextureArray::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteTextures(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::TEXTURE, m_handle);
         m_handle = INVALID;
     }
 }
@@ -94,6 +96,5 @@ void gl::TextureArray::write_layer(const void* data, int layer, const glm::ivec4
 void gl::TextureArray::use(unsigned slot) {
     assert(this->operator bool());
 
-    glActiveTexture(slot);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, m_handle);
+    gl::State::current().bind_texture(slot, m_handle);
 }
@@ -1,5 +1,7 @@
 #include <glimpse/gl.hpp>
 #include <glimpse/texture.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
@@ -50,7 +52,7 @@ gl::TextureCube::TextureCube(int width,
 
 void gl::TextureCube::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteTextures(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::TEXTURE, m_handle);
         m_handle = INVALID;
     }
 }
@@ -75,5 +77,5 @@ gl::TextureCube& gl::TextureCube::operator=(gl::TextureCube&& other) noexcept {
 void gl::TextureCube::use(unsigned slot) {
     assert(this->operator bool());
 
-    glBindTextureUnit(slot, m_handle);
+    gl::State::current().bind_texture(slot, m_handle);
 }
@@ -0,0 +1,106 @@
+#include <glimpse/transform_feedback.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
+
+#include <GL/glew.h>
+
+#include <cassert>
+#include <stdexcept>
+
+gl::TransformFeedback::TransformFeedback(std::vector<gl::Data> targets)
+    : m_targets(std::move(targets)), m_handles(m_targets.size(), INVALID) {
+    if (m_targets.empty()) {
+        throw std::invalid_argument("Transform feedback requires at least one target");
+    }
+
+    glCreateTransformFeedbacks(1, &m_handle);
+    glCreateQueries(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, 1, &m_query);
+    rebind();
+}
+
+gl::TransformFeedback::~TransformFeedback() noexcept {
+    reset();
+}
+
+void gl::TransformFeedback::reset() noexcept {
+    if (this->operator bool()) {
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::TRANSFORM_FEEDBACK, m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::QUERY, m_query);
+        m_handle = INVALID;
+        m_query = INVALID;
+    }
+}
+
+void gl::TransformFeedback::swap(gl::TransformFeedback& other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_query, other.m_query);
+    std::swap(m_targets, other.m_targets);
+    std::swap(m_handles, other.m_handles);
+}
+
+gl::TransformFeedback::TransformFeedback(gl::TransformFeedback&& other) noexcept {
+    swap(other);
+}
+
+gl::TransformFeedback& gl::TransformFeedback::operator=(gl::TransformFeedback&& other) noexcept {
+    swap(other);
+    return *this;
+}
+
+gl::TransformFeedback& gl::TransformFeedback::operator=(std::nullptr_t) {
+    reset();
+    return *this;
+}
+
+gl::TransformFeedback::operator bool() const noexcept {
+    return m_handle != INVALID;
+}
+
+const std::vector<gl::Data>& gl::TransformFeedback::targets() const noexcept {
+    return m_targets;
+}
+
+gl::Handle gl::TransformFeedback::native_handle() const noexcept {
+    return m_handle;
+}
+
+void gl::TransformFeedback::begin(unsigned primitive) noexcept {
+    assert(this->operator bool());
+    assert(primitive == GL_POINTS || primitive == GL_LINES || primitive == GL_TRIANGLES);
+
+    rebind();
+    gl::State::current().bind_transform_feedback(m_handle);
+    glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, m_query);
+    glBeginTransformFeedback(primitive);
+}
+
+void gl::TransformFeedback::end() noexcept {
+    glEndTransformFeedback();
+    glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+    gl::State::current().bind_transform_feedback(0);
+}
+
+void gl::TransformFeedback::rebind() noexcept {
+    for (size_t i = 0; i < m_targets.size(); i++) {
+        gl::Handle handle = m_targets[i].buffer().native_handle();
+        if (handle != m_handles[i]) {
+            std::slice slice = m_targets[i].slice();
+            glTransformFeedbackBufferRange(m_handle, static_cast<GLuint>(i), handle,
+                                           static_cast<GLintptr>(slice.start()),
+                                           static_cast<GLsizeiptr>(slice.size()));
+            m_handles[i] = handle;
+        }
+    }
+}
+
+bool gl::TransformFeedback::available() const noexcept {
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+size_t gl::TransformFeedback::primitives() const noexcept {
+    GLuint primitives = 0;
+    glGetQueryObjectuiv(m_query, GL_QUERY_RESULT, &primitives);
+    return primitives;
+}
@@ -4,7 +4,87 @@
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static size_t type_size(gl::Type type) noexcept;
+static bool equal(const unsigned char* a, const unsigned char* b, size_t size) noexcept;
+
+template <typename T>
+static void apply_write(gl::Uniform& uniform, const unsigned char* values, size_t count, int first) {
+    uniform.write(reinterpret_cast<const T*>(values), count, first);
+}
+
+template <size_t... I>
+static void dispatch_write(gl::Uniform& uniform,
+                           unsigned type,
+                           const unsigned char* values,
+                           size_t count,
+                           int first,
+                           std::index_sequence<I...>) {
+    using Apply = void (*)(gl::Uniform&, const unsigned char*, size_t, int);
+    static constexpr Apply applies[] = {&apply_write<std::tuple_element_t<I, gl::UniformBatch::Types>>...};
+    applies[type](uniform, values, count, first);
+}
+
+gl::UniformShadow::UniformShadow(std::unordered_map<std::string, gl::Uniform>& uniforms) {
+    size_t offset = 0;
+    unsigned slot = 0;
+    for (auto& [name, uniform] : uniforms) {
+        size_t capacity = uniform.size() * static_cast<size_t>(std::max(uniform.count(), 1));
+        uniform.m_shadow = this;
+        uniform.m_slot = slot++;
+        uniform.m_offset = offset;
+        uniform.m_capacity = capacity;
+
+        // Keep slots 16-byte aligned, so that matrices compare in whole vectors
+        offset += (capacity + 15) / 16 * 16;
+    }
+
+    m_values.resize(offset);
+    m_known.resize(slot, 0);
+}
+
+bool gl::UniformShadow::write(unsigned slot,
+                              size_t offset,
+                              size_t capacity,
+                              size_t start,
+                              const void* value,
+                              size_t size) noexcept {
+    const auto* bytes = static_cast<const unsigned char*>(value);
+    if (start + size > capacity) {
+        m_statistics.misses++;
+        return true;
+    }
+
+    // Only the leading bytes that were written before are known, e.g. the first element of an array
+    unsigned char* shadow = m_values.data() + offset + start;
+    if (start + size <= m_known[slot] && equal(shadow, bytes, size)) {
+        m_statistics.hits++;
+        return false;
+    }
+
+    std::memcpy(shadow, bytes, size);
+    if (start <= m_known[slot]) {
+        m_known[slot] = std::max(m_known[slot], start + size);
+    }
+    m_statistics.misses++;
+    return true;
+}
+
+void gl::UniformShadow::invalidate() noexcept {
+    std::fill(m_known.begin(), m_known.end(), 0);
+}
+
+gl::UniformShadow::Statistics gl::UniformShadow::statistics() const noexcept {
+    return m_statistics;
+}
 
 gl::Uniform::Uniform() noexcept = default;
 
@@ -23,268 +103,675 @@ int gl::Uniform::count() const noexcept {
     return m_count;
 }
 
+size_t gl::Uniform::size() const noexcept {
+    return type_size(m_type);
+}
+
+int gl::Uniform::element_location(int first) {
+    if (first == 0) {
+        return m_location;
+    }
+
+    // Only explicitly located arrays are guaranteed consecutive locations, so other elements are looked up by name
+    if (m_locations.empty()) {
+        m_locations.resize(static_cast<size_t>(m_count), -1);
+        m_locations[0] = m_location;
+    }
+
+    int& location = m_locations[static_cast<size_t>(first)];
+    if (location < 0) {
+        std::string element = name();
+        if (element.size() > 3 && element.compare(element.size() - 3, 3, "[0]") == 0) {
+            element.resize(element.size() - 3);
+        }
+        element += "[" + std::to_string(first) + "]";
+        location = glGetUniformLocation(native_handle(), element.c_str());
+    }
+    return location;
+}
+
+gl::UniformHandle::UniformHandle(gl::Uniform* uniform) noexcept : m_uniform(uniform) {}
+
+gl::UniformHandle::operator bool() const noexcept {
+    return m_uniform && *m_uniform;
+}
+
+int gl::UniformHandle::location() const noexcept {
+    return m_uniform ? m_uniform->location() : -1;
+}
+
 gl::Uniform& gl::Uniform::operator=(bool value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(static_cast<int>(value))) {
         glProgramUniform1i(native_handle(), location(), value);
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(int value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform1i(native_handle(), location(), value);
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(unsigned value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform1ui(native_handle(), location(), value);
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(float value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform1f(native_handle(), location(), value);
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(double value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform1d(native_handle(), location(), value);
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::bvec2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(glm::ivec2(value))) {
         glProgramUniform2iv(native_handle(), location(), 1, glm::value_ptr(glm::ivec2(value)));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::ivec2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform2iv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::uvec2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform2uiv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::vec2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform2fv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dvec2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform2dv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::bvec3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(glm::ivec3(value))) {
         glProgramUniform3iv(native_handle(), location(), 1, glm::value_ptr(glm::ivec3(value)));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::ivec3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform3iv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::uvec3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform3uiv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::vec3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform3fv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dvec3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform3dv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::bvec4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(glm::ivec4(value))) {
         glProgramUniform4iv(native_handle(), location(), 1, glm::value_ptr(glm::ivec4(value)));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::ivec4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform4iv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::uvec4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform4uiv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::vec4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform4fv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dvec4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniform4dv(native_handle(), location(), 1, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix2fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix2dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat2x3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix2x3fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat2x3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix2x3dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat2x4& value) {
-    if (this->operator bool()) {
-        glProgramUniformMatrix2x3fv(native_handle(), location(), 1, false, glm::value_ptr(value));
+    if (this->operator bool() && changed(value)) {
+        glProgramUniformMatrix2x4fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat2x4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix2x4dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat3x2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix3x2fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat3x2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix3x2dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix3fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix3dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat3x4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix3x4fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat3x4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix3x4dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat4x2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix4x2fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat4x2& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix4x2dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat4x3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix4x3fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat4x3& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix4x3dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::mat4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix4fv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
 
 gl::Uniform& gl::Uniform::operator=(const glm::dmat4& value) {
-    if (this->operator bool()) {
+    if (this->operator bool() && changed(value)) {
         glProgramUniformMatrix4dv(native_handle(), location(), 1, false, glm::value_ptr(value));
     }
     return *this;
 }
+
+bool gl::Uniform::changed(const void* values, size_t size, size_t count, int first) {
+    if (first < 0 || static_cast<size_t>(first) + count > static_cast<size_t>(std::max(m_count, 1))) {
+        throw std::out_of_range("Writing past the end of the uniform array " + name());
+    }
+
+    if (count == 0 || !this->operator bool()) {
+        return false;
+    }
+    return !m_shadow ||
+           m_shadow->write(m_slot, m_offset, m_capacity, size * static_cast<size_t>(first), values, size * count);
+}
+
+gl::Uniform& gl::Uniform::write(const int* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform1iv(native_handle(), element_location(first), static_cast<GLsizei>(count), values);
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const unsigned* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform1uiv(native_handle(), element_location(first), static_cast<GLsizei>(count), values);
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const float* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform1fv(native_handle(), element_location(first), static_cast<GLsizei>(count), values);
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const double* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform1dv(native_handle(), element_location(first), static_cast<GLsizei>(count), values);
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::ivec2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform2iv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::uvec2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform2uiv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                             glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::vec2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform2fv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dvec2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform2dv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::ivec3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform3iv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::uvec3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform3uiv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                             glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::vec3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform3fv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dvec3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform3dv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::ivec4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform4iv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::uvec4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform4uiv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                             glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::vec4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform4fv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dvec4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniform4dv(native_handle(), element_location(first), static_cast<GLsizei>(count),
+                            glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix2fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                  glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix2dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                  glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat2x3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix2x3fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat2x3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix2x3dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat2x4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix2x4fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat2x4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix2x4dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat3x2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix3x2fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat3x2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix3x2dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix3fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                  glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix3dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                  glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat3x4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix3x4fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat3x4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix3x4dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat4x2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix4x2fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat4x2* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix4x2dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat4x3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix4x3fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat4x3* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix4x3dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                    glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::mat4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix4fv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                  glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+gl::Uniform& gl::Uniform::write(const glm::dmat4* values, size_t count, int first) {
+    if (changed(values, sizeof(*values), count, first)) {
+        glProgramUniformMatrix4dv(native_handle(), element_location(first), static_cast<GLsizei>(count), false,
+                                  glm::value_ptr(*values));
+    }
+    return *this;
+}
+
+void gl::UniformBatch::apply() const {
+    for (const Write& write : m_writes) {
+        gl::UniformBatch::write(*write.uniform, write.type, m_values.data() + write.offset, write.count, write.first);
+    }
+}
+
+void gl::UniformBatch::write(gl::Uniform& uniform, unsigned type, const void* values, size_t count, int first) {
+    dispatch_write(uniform, type, static_cast<const unsigned char*>(values), count, first,
+                   std::make_index_sequence<std::tuple_size<Types>::value>());
+}
+
+size_t gl::UniformBatch::size() const noexcept {
+    return m_writes.size();
+}
+
+void gl::UniformBatch::clear() noexcept {
+    m_writes.clear();
+    m_values.clear();
+}
+
+static size_t type_size(gl::Type type) noexcept {
+    switch (type) {
+        case GL_FLOAT_VEC2:
+        case GL_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_BOOL_VEC2:
+        case GL_DOUBLE:
+            return 8;
+        case GL_FLOAT_VEC3:
+        case GL_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_BOOL_VEC3:
+            return 12;
+        case GL_FLOAT_VEC4:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT_VEC4:
+        case GL_BOOL_VEC4:
+        case GL_DOUBLE_VEC2:
+        case GL_FLOAT_MAT2:
+            return 16;
+        case GL_DOUBLE_VEC3:
+        case GL_FLOAT_MAT2x3:
+        case GL_FLOAT_MAT3x2:
+            return 24;
+        case GL_DOUBLE_VEC4:
+        case GL_FLOAT_MAT2x4:
+        case GL_FLOAT_MAT4x2:
+        case GL_DOUBLE_MAT2:
+            return 32;
+        case GL_FLOAT_MAT3:
+            return 36;
+        case GL_FLOAT_MAT3x4:
+        case GL_FLOAT_MAT4x3:
+        case GL_DOUBLE_MAT2x3:
+        case GL_DOUBLE_MAT3x2:
+            return 48;
+        case GL_FLOAT_MAT4:
+        case GL_DOUBLE_MAT2x4:
+        case GL_DOUBLE_MAT4x2:
+            return 64;
+        case GL_DOUBLE_MAT3:
+            return 72;
+        case GL_DOUBLE_MAT3x4:
+        case GL_DOUBLE_MAT4x3:
+            return 96;
+        case GL_DOUBLE_MAT4:
+            return 128;
+        default:
+            // Scalars, samplers, images and atomic counters are written as a single 32-bit value
+            return 4;
+    }
+}
+
+static bool equal(const unsigned char* a, const unsigned char* b, size_t size) noexcept {
+#ifdef __SSE2__
+    // Compare 16 bytes at a time, so that a mat4 takes four compares
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+            return false;
+        }
+    }
+    return std::memcmp(a + i, b + i, size - i) == 0;
+#else
+    return std::memcmp(a, b, size) == 0;
+#endif
+}
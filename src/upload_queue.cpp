@@ -0,0 +1,264 @@
+#include <glimpse/upload_queue.hpp>
+#include <glimpse/state.hpp>
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+gl::UploadQueue::UploadQueue(size_t capacity) : m_staging(capacity, 2) {}
+
+size_t gl::UploadQueue::capacity() const noexcept {
+    return m_staging.region_size();
+}
+
+size_t gl::UploadQueue::pending() const noexcept {
+    return m_buffers.size() + m_textures.size();
+}
+
+size_t gl::UploadQueue::stage(const void* data, size_t size, size_t alignment) {
+    if (size + alignment - 1 > m_staging.available()) {
+        submit();
+    }
+
+    auto allocation = m_staging.allocate(size, 1, gl::ElementDescriptor::get<unsigned char>(), alignment);
+    std::memcpy(allocation.memory, data, size);
+    return allocation.data.slice().start();
+}
+
+void gl::UploadQueue::write(gl::Buffer& buffer, const void* data, size_t size, size_t offset) {
+    if (!buffer) {
+        throw std::invalid_argument("Cannot write to an invalid buffer");
+    } else if (offset + size > buffer.size()) {
+        throw std::out_of_range("The write exceeds the size of the buffer");
+    } else if (size == 0) {
+        return;
+    }
+
+    m_statistics.bytes += size;
+    m_statistics.writes++;
+
+    if (size > m_staging.region_size()) {
+        // Preserve the order with respect to the queued writes
+        submit();
+        buffer.write(data, size, static_cast<int>(offset));
+        m_statistics.commands++;
+        return;
+    }
+
+    size_t source = stage(data, size, 1);
+    m_buffers.push_back({&buffer, source, offset, size});
+}
+
+void gl::UploadQueue::write(gl::Texture& texture, const void* data, const glm::ivec4& region, int alignment) {
+    if (!texture) {
+        throw std::invalid_argument("Cannot write to an invalid texture");
+    } else if (texture.samples()) {
+        throw std::logic_error("Multisample textures are not writable directly");
+    } else if (region.x < 0 || region.y < 0 || region.z < 0 || region.w < 0 ||
+               region.x + region.z > texture.width() || region.y + region.w > texture.height()) {
+        throw std::out_of_range("The region exceeds the size of the texture");
+    }
+
+    auto [base_format, internal_format] = texture.dtype().format(texture.components());
+
+    TextureCopy copy{};
+    copy.texture = texture.native_handle();
+    copy.offset = glm::ivec3(region.x, region.y, 0);
+    copy.extent = glm::ivec3(region.z, region.w, 1);
+    copy.format = base_format;
+    copy.type = texture.dtype().type();
+    copy.alignment = alignment;
+    copy.volume = false;
+
+    size_t row = static_cast<size_t>(region.z) * static_cast<size_t>(texture.components()) * texture.dtype().size();
+    enqueue(copy, data, row, static_cast<size_t>(region.w), texture.dtype().size());
+}
+
+void gl::UploadQueue::write(gl::Texture3D& texture, const void* data, int slice, int slices, int alignment) {
+    if (!texture) {
+        throw std::invalid_argument("Cannot write to an invalid texture");
+    } else if (slice < 0 || slices < 0 || slice + slices > texture.depth()) {
+        throw std::out_of_range("The slices exceed the depth of the texture");
+    }
+
+    auto [base_format, internal_format] = texture.dtype().format(texture.components());
+
+    TextureCopy copy{};
+    copy.texture = texture.native_handle();
+    copy.offset = glm::ivec3(0, 0, slice);
+    copy.extent = glm::ivec3(texture.width(), texture.height(), slices);
+    copy.format = base_format;
+    copy.type = texture.dtype().type();
+    copy.alignment = alignment;
+    copy.volume = true;
+
+    size_t row = static_cast<size_t>(texture.width()) * static_cast<size_t>(texture.components()) *
+                 texture.dtype().size();
+    enqueue(copy, data, row, static_cast<size_t>(texture.height()) * static_cast<size_t>(slices),
+            texture.dtype().size());
+}
+
+void gl::UploadQueue::enqueue(TextureCopy copy, const void* data, size_t row, size_t rows, size_t element) {
+    // The offset of the pixels in the staging buffer must be a multiple of the component size
+    const size_t staging_alignment = element && !(element & (element - 1)) ? element : 4;
+
+    if (copy.alignment != 1 && copy.alignment != 2 && copy.alignment != 4 && copy.alignment != 8) {
+        throw std::invalid_argument("Alignment must be 1, 2, 4 or 8");
+    } else if (row == 0 || rows == 0) {
+        return;
+    }
+
+    // Only the rows before the last one are padded, so the copy does not read past the data of the caller
+    const auto alignment = static_cast<size_t>(copy.alignment);
+    const size_t padded_row = (row + alignment - 1) / alignment * alignment;
+    copy.padding = padded_row - row;
+    copy.size = padded_row * (rows - 1) + row;
+
+    m_statistics.bytes += copy.size;
+    m_statistics.writes++;
+
+    if (copy.size + staging_alignment - 1 > m_staging.region_size()) {
+        // Preserve the order with respect to the queued writes
+        submit();
+
+        GLint previous = 4;
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, copy.alignment);
+        if (copy.volume) {
+            glTextureSubImage3D(copy.texture, 0, copy.offset.x, copy.offset.y, copy.offset.z, copy.extent.x,
+                                copy.extent.y, copy.extent.z, copy.format, copy.type, data);
+        } else {
+            glTextureSubImage2D(copy.texture, 0, copy.offset.x, copy.offset.y, copy.extent.x, copy.extent.y,
+                                copy.format, copy.type, data);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, previous);
+        m_statistics.commands++;
+        return;
+    }
+
+    copy.source = stage(data, copy.size, staging_alignment);
+    m_textures.push_back(copy);
+}
+
+gl::UploadQueue::Statistics gl::UploadQueue::flush() {
+    submit();
+
+    Statistics statistics = m_statistics;
+    m_statistics = Statistics{};
+    return statistics;
+}
+
+void gl::UploadQueue::submit() {
+    if (m_buffers.empty() && m_textures.empty()) {
+        return;
+    }
+
+    const gl::Handle staging = m_staging.buffer()->native_handle();
+
+    // The staging offsets increase with every write, so sorting by them restores the submission order
+    std::sort(m_buffers.begin(), m_buffers.end(), [](const BufferCopy& lhs, const BufferCopy& rhs) {
+        return std::less<>()(lhs.buffer, rhs.buffer) || (lhs.buffer == rhs.buffer && lhs.source < rhs.source);
+    });
+
+    for (auto first = m_buffers.begin(); first != m_buffers.end();) {
+        auto last = std::find_if(first, m_buffers.end(),
+                                 [&](const BufferCopy& copy) { return copy.buffer != first->buffer; });
+
+        // Sort the writes to a buffer by offset, unless overlapping writes depend on their order
+        std::sort(first, last, [](const BufferCopy& lhs, const BufferCopy& rhs) { return lhs.offset < rhs.offset; });
+        auto overlap = std::adjacent_find(first, last, [](const BufferCopy& lhs, const BufferCopy& rhs) {
+            return lhs.offset + lhs.size > rhs.offset;
+        });
+        if (overlap != last) {
+            std::sort(first, last,
+                      [](const BufferCopy& lhs, const BufferCopy& rhs) { return lhs.source < rhs.source; });
+        }
+
+        // Merge ranges that are contiguous in both the staging and the destination buffer
+        for (auto it = first; it != last;) {
+            BufferCopy merged = *it;
+            for (++it; it != last && it->source == merged.source + merged.size &&
+                       it->offset == merged.offset + merged.size;
+                 ++it) {
+                merged.size += it->size;
+            }
+
+            // Query the handle now, since round-robin buffers may have rotated since the write was queued
+            glCopyNamedBufferSubData(staging, merged.buffer->native_handle(), static_cast<GLintptr>(merged.source),
+                                     static_cast<GLintptr>(merged.offset), static_cast<GLsizeiptr>(merged.size));
+            m_statistics.commands++;
+        }
+
+        first = last;
+    }
+
+    std::sort(m_textures.begin(), m_textures.end(), [](const TextureCopy& lhs, const TextureCopy& rhs) {
+        return lhs.texture < rhs.texture || (lhs.texture == rhs.texture && lhs.source < rhs.source);
+    });
+
+    // Restore the unpack alignment of the context after the batch
+    GLint previous = 4;
+    if (!m_textures.empty()) {
+        gl::State::current().bind_buffer(GL_PIXEL_UNPACK_BUFFER, staging);
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous);
+    }
+
+    int alignment = previous;
+    for (auto it = m_textures.begin(); it != m_textures.end();) {
+        TextureCopy merged = *it;
+
+        // Merge consecutive rows of a texture, or consecutive slices of a volume, with the same layout
+        for (++it; it != m_textures.end(); ++it) {
+            const int axis = merged.volume ? 2 : 1;
+            bool adjacent = it->texture == merged.texture && it->volume == merged.volume &&
+                            it->format == merged.format && it->type == merged.type &&
+                            it->alignment == merged.alignment && it->padding == merged.padding &&
+                            it->source == merged.source + merged.size + merged.padding &&
+                            it->offset[axis] == merged.offset[axis] + merged.extent[axis];
+
+            for (int i = 0; i < 3 && adjacent; i++) {
+                adjacent = i == axis || (it->offset[i] == merged.offset[i] && it->extent[i] == merged.extent[i]);
+            }
+
+            if (!adjacent) {
+                break;
+            }
+
+            // The last row of the merged range is now followed by another row, so it is padded
+            merged.extent[axis] += it->extent[axis];
+            merged.size += merged.padding + it->size;
+        }
+
+        if (merged.alignment != alignment) {
+            alignment = merged.alignment;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        }
+
+        const auto* source = reinterpret_cast<const void*>(merged.source);
+        if (merged.volume) {
+            glTextureSubImage3D(merged.texture, 0, merged.offset.x, merged.offset.y, merged.offset.z,
+                                merged.extent.x, merged.extent.y, merged.extent.z, merged.format, merged.type,
+                                source);
+        } else {
+            glTextureSubImage2D(merged.texture, 0, merged.offset.x, merged.offset.y, merged.extent.x,
+                                merged.extent.y, merged.format, merged.type, source);
+        }
+        m_statistics.commands++;
+    }
+
+    if (!m_textures.empty()) {
+        // Other texture uploads source client memory
+        gl::State::current().bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    if (alignment != previous) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, previous);
+    }
+
+    m_buffers.clear();
+    m_textures.clear();
+    m_staging.next_frame();
+}
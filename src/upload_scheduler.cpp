@@ -0,0 +1,110 @@
+#include <glimpse/upload_scheduler.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+gl::UploadScheduler::UploadScheduler(size_t budget, size_t staging) : m_queue(staging), m_budget(budget) {
+    if (budget == 0) {
+        throw std::invalid_argument("The upload budget cannot be zero");
+    }
+}
+
+size_t gl::UploadScheduler::budget() const noexcept {
+    return m_budget;
+}
+
+void gl::UploadScheduler::set_budget(size_t budget) {
+    if (budget == 0) {
+        throw std::invalid_argument("The upload budget cannot be zero");
+    }
+
+    m_budget = budget;
+}
+
+size_t gl::UploadScheduler::pending() const noexcept {
+    size_t pending = 0;
+    for (const Job& job : m_jobs) {
+        pending += job.size - job.done;
+    }
+    return pending;
+}
+
+size_t gl::UploadScheduler::pitch(int width, int components, const gl::PixelType& dtype, int alignment) noexcept {
+    size_t row = static_cast<size_t>(width) * static_cast<size_t>(components) * dtype.size();
+    return (row + static_cast<size_t>(alignment) - 1) / static_cast<size_t>(alignment) * static_cast<size_t>(alignment);
+}
+
+std::shared_ptr<const bool> gl::UploadScheduler::schedule(Job job,
+                                                          std::shared_ptr<const void> data,
+                                                          const void* bytes,
+                                                          size_t size,
+                                                          std::shared_ptr<const void> resource,
+                                                          size_t expected) {
+    if (size < expected) {
+        throw std::invalid_argument("The data is smaller than the resource");
+    }
+
+    job.data = std::move(data);
+    job.resource = std::move(resource);
+    job.ready = std::make_shared<bool>(false);
+    job.bytes = static_cast<const unsigned char*>(bytes);
+    job.size = expected;
+    job.done = 0;
+
+    if (expected == 0) {
+        *job.ready = true;
+        return job.ready;
+    }
+
+    m_jobs.push_back(job);
+    return job.ready;
+}
+
+gl::UploadQueue::Statistics gl::UploadScheduler::update() {
+    size_t remaining = m_budget;
+    bool progress = false;
+
+    for (Job& job : m_jobs) {
+        // Keep the chunks within the staging buffer, so they are batched with the other writes
+        size_t units = std::min(remaining, m_queue.capacity()) / job.unit;
+
+        if (units == 0 && progress) {
+            break;
+        }
+
+        units = std::clamp<size_t>(units, 1, (job.size - job.done) / job.unit);
+
+        const size_t first = job.done / job.unit;
+        const unsigned char* chunk = job.bytes + job.done;
+        const size_t size = units * job.unit;
+
+        if (job.buffer) {
+            m_queue.write(*job.buffer, chunk, size, job.done);
+        } else if (job.texture) {
+            glm::ivec4 region(0, static_cast<int>(first), job.texture->width(), static_cast<int>(units));
+            m_queue.write(*job.texture, chunk, region, job.alignment);
+        } else if (job.volume) {
+            m_queue.write(*job.volume, chunk, static_cast<int>(first), static_cast<int>(units), job.alignment);
+        }
+
+        job.done += size;
+        remaining -= std::min(remaining, size);
+        progress = true;
+
+        if (remaining == 0) {
+            break;
+        }
+    }
+
+    gl::UploadQueue::Statistics statistics = m_queue.flush();
+
+    // The copies of the completed jobs have been submitted, so commands issued from now on see the contents
+    auto completed =
+        std::stable_partition(m_jobs.begin(), m_jobs.end(), [](const Job& job) { return job.done < job.size; });
+    for (auto it = completed; it != m_jobs.end(); ++it) {
+        *it->ready = true;
+    }
+    m_jobs.erase(completed, m_jobs.end());
+
+    return statistics;
+}
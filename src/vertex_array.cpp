@@ -1,21 +1,34 @@
 #include <glimpse/attribute.hpp>
 #include <glimpse/vertex_array.hpp>
+#include <glimpse/deletion_queue.hpp>
+#include <glimpse/state.hpp>
 
 #include <GL/glew.h>
 
+#include <algorithm>
+#include <cassert>
 #include <stdexcept>
 
+static GLenum index_type(const gl::Data& indices);
+
 gl::VertexArray::VertexArray(std::shared_ptr<gl::Program> program,
                              const std::unordered_map<std::string, gl::Data>& data,
                              std::optional<gl::Data> indices)
-    : m_program(program), m_indices(indices), m_data(data), m_num_vertices(indices ? indices->size() : 0) {
+    : m_program(program),
+      m_indices(indices),
+      m_data(data),
+      m_index_type(indices ? index_type(*indices) : GL_UNSIGNED_INT),
+      m_num_vertices(indices ? indices->size() : 0) {
     glCreateVertexArrays(1, &m_handle);
 
-    if (indices) {
-        glVertexArrayElementBuffer(m_handle, indices->buffer().native_handle());
+    bool sized = m_indices.has_value();
+
+    if (m_indices) {
+        m_index_handle = m_indices->buffer().native_handle();
+        glVertexArrayElementBuffer(m_handle, m_index_handle);
     }
 
-    for (auto& [name, view] : data) {
+    for (auto& [name, view] : m_data) {
         // Unknown attributes are ignored
         if (program->attributes.count(name) == 0) {
             continue;
@@ -23,17 +36,43 @@ gl::VertexArray::VertexArray(std::shared_ptr<gl::Program> program,
         const gl::Attribute& attrib = program->attributes[name];
         std::slice slice = view.slice();
         gl::ElementDescriptor descriptor = view.descriptor();
-        glVertexArrayVertexBuffer(m_handle, attrib.location(), view.buffer().native_handle(), 0,
-                                  static_cast<GLsizei>(slice.stride()));
-        glVertexArrayAttribFormat(m_handle, attrib.location(), descriptor.count(), descriptor.type(), GL_FALSE,
-                                  static_cast<GLintptr>(slice.start()));
+        // Bind the buffer at the start of the slice, so views into large shared buffers do not exceed the
+        // maximum relative attribute offset
+        glVertexArrayVertexBuffer(m_handle, attrib.location(), view.buffer().native_handle(),
+                                  static_cast<GLintptr>(slice.start()), static_cast<GLsizei>(slice.stride()));
+        glVertexArrayAttribFormat(m_handle, attrib.location(), descriptor.count(), descriptor.type(), GL_FALSE, 0);
+        glVertexArrayBindingDivisor(m_handle, attrib.location(), view.divisor());
         glEnableVertexArrayAttrib(m_handle, attrib.location());
+        m_bindings.push_back({attrib.location(), &view, view.buffer().native_handle()});
+
+        // Without indices, draw as many vertices as the shortest per-vertex stream holds
+        if (!m_indices && view.divisor() == 0) {
+            m_num_vertices = sized ? std::min(m_num_vertices, view.size()) : view.size();
+            sized = true;
+        }
+    }
+}
+
+void gl::VertexArray::rebind() const noexcept {
+    for (Binding& binding : m_bindings) {
+        gl::Handle handle = binding.data->buffer().native_handle();
+        if (handle != binding.handle) {
+            std::slice slice = binding.data->slice();
+            glVertexArrayVertexBuffer(m_handle, binding.index, handle, static_cast<GLintptr>(slice.start()),
+                                      static_cast<GLsizei>(slice.stride()));
+            binding.handle = handle;
+        }
+    }
+
+    if (m_indices && m_indices->buffer().native_handle() != m_index_handle) {
+        m_index_handle = m_indices->buffer().native_handle();
+        glVertexArrayElementBuffer(m_handle, m_index_handle);
     }
 }
 
 void gl::VertexArray::reset() noexcept {
     if (this->operator bool()) {
-        glDeleteVertexArrays(1, &m_handle);
+        gl::DeletionQueue::release(gl::DeletionQueue::Kind::VERTEX_ARRAY, m_handle);
         m_handle = INVALID;
     }
 }
@@ -43,7 +82,11 @@ void gl::VertexArray::swap(gl::VertexArray& other) noexcept {
     std::swap(m_program, other.m_program);
     std::swap(m_indices, other.m_indices);
     std::swap(m_data, other.m_data);
+    std::swap(m_bindings, other.m_bindings);
+    std::swap(m_index_handle, other.m_index_handle);
+    std::swap(m_index_type, other.m_index_type);
     std::swap(m_num_vertices, other.m_num_vertices);
+    std::swap(m_primitive_restart, other.m_primitive_restart);
 }
 
 gl::VertexArray::VertexArray(gl::VertexArray&& other) noexcept {
@@ -55,20 +98,114 @@ gl::VertexArray& gl::VertexArray::operator=(gl::VertexArray&& other) noexcept {
     return *this;
 }
 
-void gl::VertexArray::render(unsigned mode, int vertices) const {
+void gl::VertexArray::set_primitive_restart(bool enabled) noexcept {
+    m_primitive_restart = enabled;
+}
+
+bool gl::VertexArray::primitive_restart() const noexcept {
+    return m_primitive_restart;
+}
+
+void gl::VertexArray::bind() const noexcept {
     assert(this->operator bool());
 
-    glUseProgram(m_program->native_handle());
+    gl::State& state = gl::State::current();
+    state.use_program(m_program->native_handle());
+
+    rebind();
+    state.bind_vertex_array(m_handle);
+    state.set_enabled(GL_PRIMITIVE_RESTART_FIXED_INDEX, m_primitive_restart);
+}
+
+const void* gl::VertexArray::index_offset(int first) const noexcept {
+    size_t offset = m_indices->slice().start() + static_cast<size_t>(first) * m_indices->slice().stride();
+    return reinterpret_cast<const void*>(offset);
+}
+
+void gl::VertexArray::render(unsigned mode, int vertices, int first, int base_vertex) const {
+    if (vertices < 0) {
+        vertices = static_cast<int>(m_num_vertices) - first;
+    }
+
+    bind();
+
+    if (!m_indices) {
+        glDrawArrays(mode, first, vertices);
+    } else if (base_vertex != 0) {
+        glDrawElementsBaseVertex(mode, vertices, m_index_type, index_offset(first), base_vertex);
+    } else {
+        glDrawElements(mode, vertices, m_index_type, index_offset(first));
+    }
+}
 
+void gl::VertexArray::render_instanced(unsigned mode, int vertices, int instances, unsigned base_instance) const {
     if (vertices < 0) {
         vertices = static_cast<int>(m_num_vertices);
     }
 
-    glBindVertexArray(m_handle);
+    bind();
 
     if (m_indices) {
-        glDrawElements(mode, vertices, GL_UNSIGNED_INT, nullptr);
+        glDrawElementsInstancedBaseInstance(mode, vertices, m_index_type, index_offset(0), instances, base_instance);
     } else {
-        glDrawArrays(mode, 0, vertices);
+        glDrawArraysInstancedBaseInstance(mode, 0, vertices, instances, base_instance);
+    }
+}
+
+void gl::VertexArray::render(unsigned mode,
+                             gl::TransformFeedback& feedback,
+                             unsigned primitive,
+                             int vertices,
+                             bool rasterize) const {
+    gl::State& state = gl::State::current();
+    state.set_enabled(GL_RASTERIZER_DISCARD, !rasterize);
+
+    // The program must be in use before capturing starts
+    state.use_program(m_program->native_handle());
+    feedback.begin(primitive);
+    render(mode, vertices);
+    feedback.end();
+
+    state.set_enabled(GL_RASTERIZER_DISCARD, false);
+}
+
+void gl::VertexArray::render_feedback(unsigned mode, const gl::TransformFeedback& feedback) const {
+    bind();
+    glDrawTransformFeedback(mode, feedback.native_handle());
+}
+
+void gl::VertexArray::render_indirect(unsigned mode,
+                                      const gl::TypedData<gl::DrawElementsIndirectCommand>& commands) const {
+    if (!m_indices) {
+        throw std::logic_error("Indexed draw commands require an index buffer");
     }
+
+    bind();
+    gl::State::current().bind_buffer(GL_DRAW_INDIRECT_BUFFER, commands.buffer().native_handle());
+    glMultiDrawElementsIndirect(mode, m_index_type, reinterpret_cast<const void*>(commands.slice().start()),
+                                static_cast<GLsizei>(commands.size()), static_cast<GLsizei>(commands.slice().stride()));
+}
+
+void gl::VertexArray::render_indirect(unsigned mode,
+                                      const gl::TypedData<gl::DrawArraysIndirectCommand>& commands) const {
+    bind();
+    gl::State::current().bind_buffer(GL_DRAW_INDIRECT_BUFFER, commands.buffer().native_handle());
+    glMultiDrawArraysIndirect(mode, reinterpret_cast<const void*>(commands.slice().start()),
+                              static_cast<GLsizei>(commands.size()), static_cast<GLsizei>(commands.slice().stride()));
+}
+
+static GLenum index_type(const gl::Data& indices) {
+    // Indices are unsigned, but signed integers of the same size are accepted as well
+    if (indices.descriptor().count() == 1) {
+        switch (indices.descriptor().size()) {
+            case 1:
+                return GL_UNSIGNED_BYTE;
+            case 2:
+                return GL_UNSIGNED_SHORT;
+            case 4:
+                return GL_UNSIGNED_INT;
+        }
+    }
+
+    throw std::invalid_argument("Indices must be 8, 16 or 32 bit integers");
 }